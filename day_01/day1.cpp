@@ -1,4 +1,6 @@
+#include "utils/bench.hpp"
 #include <charconv>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
 #include <optional>
@@ -32,18 +34,13 @@ constexpr std::optional<uint8_t> parseSignedMovement(std::string_view line) {
     return std::nullopt;
   }
 }
-} // namespace
 
-int main() {
-  // Create a view of each line from standard input (the lines are supposed to
-  // be correctly formed so no space in a line)
-  std::ifstream input{"input.txt"};
-  auto lines_view = std::views::istream<std::string>(input);
+// Process each movement line by parsing it, filtering ut the invalid
+// movements and updating the cursor position and counting the number of times
+// we cross position 0.
+uint64_t countZeroes(std::ranges::input_range auto &&lines_view) {
   uint8_t position{50};
   uint64_t counter{0};
-  // Process each movement line by parsing it, filtering ut the invalid
-  // movements and updating the cursor position and counting the number of times
-  // we cross position 0.
   for (const auto movement :
        lines_view | std::views::transform(parseSignedMovement) |
            std::views::filter([](const auto &opt) { return opt.has_value(); }) |
@@ -54,6 +51,31 @@ int main() {
       counter += 1;
     }
   }
+  return counter;
+}
+} // namespace
+
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{"L68\nL30\nR48\nL5\nR60\n"
+                                   "L55\nL1\nL99\nR14\nL82"};
+
+utils::bench::Registration const benchCountZeroes{
+    "day1/countZeroes",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) {
+      return countZeroes(utils::bench::getLines(input));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+int main() {
+  // Create a view of each line from standard input (the lines are supposed to
+  // be correctly formed so no space in a line)
+  std::ifstream input{"input.txt"};
+  auto counter = countZeroes(std::views::istream<std::string>(input));
   std::cout << "Number of times we crossed the position 0: " << counter << '\n';
   return 0;
 }
+#endif
@@ -1,48 +1,61 @@
+#include "utils/bench.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
+#include <algorithm>
+#include <array>
 #include <cstddef>
 #include <cstdint>
-#include <fcntl.h>
 #include <iostream>
+#include <ranges>
 #include <span>
+#include <string>
 #include <string_view>
-#include <sys/mman.h>
-#include <sys/stat.h>
-#include <unistd.h>
+#include <thread>
 #include <utility>
+#include <vector>
 
 namespace {
 
 constexpr uint_fast32_t dialSize{100};
-struct Parser {
-  // Supposing well-formed input
-  constexpr Parser(std::span<const char> data) {
-    char const *readingHead = data.data();
-    char const *end = data.data() + data.size();
-    while (readingHead < end) {
-      Direction dir;
-      if (*readingHead == 'L') {
-        dir = Direction::LEFT;
-      } else if (*readingHead == 'R') {
-        dir = Direction::RIGHT;
-      } else {
-        std::unreachable();
-      }
-      readingHead++;
-      uint_fast32_t nbSteps{0};
-      while (*readingHead != '\n') {
-        nbSteps = nbSteps * 10 + static_cast<uint_fast32_t>(*readingHead - '0');
-        readingHead++;
-      }
-      update(dir, nbSteps);
-      // Skip the '\n'
+enum struct Direction { LEFT, RIGHT };
+
+// Supposing well-formed input
+constexpr void forEachMovement(std::span<const char> data, auto &&callback) {
+  char const *readingHead = data.data();
+  char const *end = data.data() + data.size();
+  while (readingHead < end) {
+    Direction dir;
+    if (*readingHead == 'L') {
+      dir = Direction::LEFT;
+    } else if (*readingHead == 'R') {
+      dir = Direction::RIGHT;
+    } else {
+      std::unreachable();
+    }
+    readingHead++;
+    uint_fast32_t nbSteps{0};
+    while (*readingHead != '\n') {
+      nbSteps = nbSteps * 10 + static_cast<uint_fast32_t>(*readingHead - '0');
       readingHead++;
     }
+    callback(dir, nbSteps);
+    // Skip the '\n'
+    readingHead++;
+  }
+}
+
+struct Parser {
+  constexpr Parser(std::span<const char> data, uint_fast8_t start = 50)
+      : position(start) {
+    forEachMovement(data, [this](Direction dir, uint_fast32_t nbSteps) {
+      update(dir, nbSteps);
+    });
   }
 
   constexpr auto getCount() const { return count; }
   constexpr auto getPosition() const { return position; }
 
 private:
-  enum struct Direction { LEFT, RIGHT };
   constexpr void update(Direction dir, uint_fast32_t nbSteps) {
     count += nbSteps / dialSize;
     nbSteps = nbSteps % dialSize;
@@ -60,10 +73,86 @@ private:
       position = newPos;
     }
   }
-  uint_fast8_t position{50};
-  uint_fast16_t count{0};
+  uint_fast8_t position;
+  uint_fast64_t count{0};
+};
+
+// Effect of a run of movements for every possible start position: starting
+// from p, the dial ends on (p + offset) % dialSize after crossing 0
+// crossings[p] times. Summaries of consecutive runs compose with then().
+struct DialSummary {
+  uint_fast32_t offset{0};
+  std::array<uint_fast64_t, dialSize> crossings{};
+
+  // Single pass: a movement crosses 0 for a cyclic interval of positions, so
+  // we only record the interval bounds and integrate at the end.
+  static constexpr DialSummary from(std::span<const char> data) {
+    DialSummary res{};
+    uint_fast64_t fullTurns{0};
+    std::array<int_fast64_t, dialSize + 1> deltas{};
+    // Positions q in [first, last] before the move, seen from the start
+    auto addInterval = [&deltas, &res](uint_fast32_t first,
+                                       uint_fast32_t last) {
+      auto start = (first + dialSize - res.offset) % dialSize;
+      auto end = start + (last - first) + 1;
+      deltas[start] += 1;
+      if (end <= dialSize) {
+        deltas[end] -= 1;
+      } else {
+        deltas[dialSize] -= 1;
+        deltas[0] += 1;
+        deltas[end - dialSize] -= 1;
+      }
+    };
+    forEachMovement(data, [&](Direction dir, uint_fast32_t nbSteps) {
+      fullTurns += nbSteps / dialSize;
+      nbSteps = nbSteps % dialSize;
+      if (nbSteps == 0)
+        return;
+      if (dir == Direction::LEFT) {
+        addInterval(1, nbSteps);
+        res.offset = (res.offset + dialSize - nbSteps) % dialSize;
+      } else {
+        addInterval(dialSize - nbSteps, dialSize - 1);
+        res.offset = (res.offset + nbSteps) % dialSize;
+      }
+    });
+    int_fast64_t running{0};
+    for (size_t p{0}; p < dialSize; ++p) {
+      running += deltas[p];
+      res.crossings[p] = fullTurns + static_cast<uint_fast64_t>(running);
+    }
+    return res;
+  }
+
+  constexpr DialSummary then(DialSummary const &next) const {
+    DialSummary res{};
+    res.offset = (offset + next.offset) % dialSize;
+    for (size_t p{0}; p < dialSize; ++p) {
+      res.crossings[p] = crossings[p] + next.crossings[(p + offset) % dialSize];
+    }
+    return res;
+  }
 };
 
+uint_fast64_t getCountParallel(std::string_view input, size_t nbThreads) {
+  auto chunks = utils::splitChunks(input, nbThreads);
+  std::vector<DialSummary> summaries(chunks.size());
+  {
+    std::vector<std::jthread> workers{};
+    for (auto [chunk, summary] : std::views::zip(chunks, summaries)) {
+      workers.emplace_back([chunk, &summary] {
+        summary = DialSummary::from({chunk.data(), chunk.size()});
+      });
+    }
+  }
+  auto total = std::ranges::fold_left(summaries, DialSummary{},
+                                      [](auto const &acc, auto const &next) {
+                                        return acc.then(next);
+                                      });
+  return total.crossings[50];
+}
+
 namespace test {
 consteval auto getExpected(std::string_view input) {
   Parser parser{std::span<const char>{input.data(), input.size()}};
@@ -91,37 +180,72 @@ static_assert(getExpected("L50\nL100\n") == 2);
 static_assert(getExpected("L50\nL101\n") == 2);
 static_assert(getExpected("L50\nL200\n") == 3);
 
+// The summaries must agree with the serial parser from every start position,
+// however the input is cut at line boundaries.
+consteval bool summaryMatchesSerial(std::string_view input) {
+  std::span<const char> data{input.data(), input.size()};
+  for (size_t cut{0}; cut <= data.size(); ++cut) {
+    if (cut != 0 && data[cut - 1] != '\n')
+      continue;
+    auto summary = DialSummary::from(data.first(cut))
+                       .then(DialSummary::from(data.subspan(cut)));
+    for (uint_fast8_t start{0}; start < dialSize; ++start) {
+      Parser parser{data, start};
+      if (summary.crossings[start] != parser.getCount() ||
+          (start + summary.offset) % dialSize != parser.getPosition())
+        return false;
+    }
+  }
+  return true;
+}
+
+static_assert(summaryMatchesSerial("R15\nL15\nL50\nR50\n"));
+static_assert(summaryMatchesSerial("L99\nR99\nL101\nR101\n"));
+static_assert(summaryMatchesSerial("L149\nR149\nL150\nR150\n"));
+static_assert(summaryMatchesSerial("R50\nR100\nR101\nR200\n"));
+static_assert(summaryMatchesSerial("L50\nL100\nL101\nL200\n"));
+static_assert(summaryMatchesSerial("L68\nL30\nR48\nL5\nR60\nL55\nL1\nL99\n"
+                                   "R14\nL82\n"));
+
 }; // namespace test
 
 } // namespace
 
-int main() {
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{"L68\nL30\nR48\nL5\nR60\n"
+                                   "L55\nL1\nL99\nR14\nL82\n"};
 
-  int fd = open("input.txt", O_RDONLY, S_IRUSR | S_IWUSR);
-  if (fd == -1) {
-    return -1;
-  }
-  struct stat sb;
-  if (fstat(fd, &sb) == -1) {
-    return -1;
-  }
-  size_t file_size = sb.st_size;
+auto makeInput(size_t scale) {
+  return utils::bench::repeatLines(example, scale);
+}
 
-  void *addr = mmap(NULL, file_size, PROT_READ, MAP_SHARED, fd, 0);
-  if (addr == MAP_FAILED) {
-    return -1;
-  }
+utils::bench::Registration const benchParser{
+    "day1_1_mmap/Parser", makeInput, [](std::string_view input) -> uint64_t {
+      return Parser{{input.data(), input.size()}}.getCount();
+    }};
 
-  char *file_content = static_cast<char *>(addr);
-  std::span char_view{file_content, file_size};
+utils::bench::Registration const benchParallel{
+    "day1_1_mmap/parallel", makeInput, [](std::string_view input) -> uint64_t {
+      return getCountParallel(input, utils::getNbThreads());
+    }};
+} // namespace
 
-  Parser parser{char_view};
-  auto counter = parser.getCount();
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional argument: number of threads, 1 runs the serial parser
+int main(int argc, char **argv) {
+  auto nbThreads = argc > 1 ? std::stoul(argv[1]) : utils::getNbThreads();
+  utils::MappedInput input{"input.txt"};
+  auto content = input.readAll();
+
+  uint_fast64_t counter{0};
+  if (nbThreads <= 1) {
+    counter = Parser{{content.data(), content.size()}}.getCount();
+  } else {
+    counter = getCountParallel(content, nbThreads);
+  }
 
   std::cout << "Number of times we crossed the position 0:" << counter << '\n';
-
-  if (munmap(addr, file_size) == -1) {
-    return -1;
-  }
-  close(fd);
 }
+#endif
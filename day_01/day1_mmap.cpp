@@ -1,8 +1,10 @@
+#include "utils/bench.hpp"
 #include <cstddef>
 #include <cstdint>
 #include <fcntl.h>
 #include <iostream>
 #include <span>
+#include <string_view>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
@@ -11,9 +13,9 @@
 namespace {
 struct Parser {
   // Supposing well-formed input
-  constexpr Parser(std::span<char> data) {
-    char *readingHead = data.data();
-    char *end = data.data() + data.size();
+  constexpr Parser(std::span<const char> data) {
+    char const *readingHead = data.data();
+    char const *end = data.data() + data.size();
     while (readingHead < end) {
       Direction dir;
       if (*readingHead == 'L') {
@@ -59,6 +61,21 @@ private:
 
 } // namespace
 
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{"L68\nL30\nR48\nL5\nR60\n"
+                                   "L55\nL1\nL99\nR14\nL82\n"};
+
+utils::bench::Registration const benchParser{
+    "day1_mmap/Parser",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return Parser{{input.data(), input.size()}}.getCount();
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
 
   int fd = open("input.txt", O_RDONLY, S_IRUSR | S_IWUSR);
@@ -89,3 +106,4 @@ int main() {
   }
   close(fd);
 }
+#endif
@@ -7,8 +7,11 @@
 #include <string>
 #include <string_view>
 
-#include "utils/decimal.hpp"
+#include "utils/bench.hpp"
 #include "utils/parser.hpp"
+#include "utils/repdigits.hpp"
+
+using Digits = utils::RepDigits<uint_fast32_t>;
 
 struct Range {
   uint_fast32_t start;
@@ -32,12 +35,11 @@ std::generator<Range> getRanges(std::string_view input) {
 }
 
 constexpr uint_fast32_t findFirstInvalidStemAfter(uint_fast32_t start) {
-  constexpr auto powerOfTen = utils::powersOfTen<uint_fast32_t>();
-  auto nbDigits = utils::getDecimalDigits(start);
+  auto nbDigits = Digits::getWidth(start);
   if (nbDigits % 2 == 1) {
-    return powerOfTen[nbDigits / 2];
+    return Digits::powers[nbDigits / 2];
   }
-  auto halfPower = powerOfTen[nbDigits / 2];
+  auto halfPower = Digits::powers[nbDigits / 2];
   auto highDigits = start / halfPower;
   ;
   auto lowDigits = start % halfPower;
@@ -53,12 +55,11 @@ static_assert(findFirstInvalidStemAfter(2227) == 23);
 static_assert(findFirstInvalidStemAfter(5527) == 55);
 
 constexpr uint_fast32_t findLastValidStemBefore(uint_fast32_t start) {
-  constexpr auto powerOfTen = utils::powersOfTen<uint_fast32_t>();
-  auto nbDigits = utils::getDecimalDigits(start);
+  auto nbDigits = Digits::getWidth(start);
   if (nbDigits % 2 == 1) {
-    return powerOfTen[nbDigits / 2] - 1;
+    return Digits::allNines[nbDigits / 2];
   }
-  auto halfPower = powerOfTen[nbDigits / 2];
+  auto halfPower = Digits::powers[nbDigits / 2];
   auto highDigits = start / halfPower;
   auto lowDigits = start % halfPower;
 
@@ -75,9 +76,8 @@ static_assert(findLastValidStemBefore(8784) == 86);
 static_assert(findLastValidStemBefore(5555) == 55);
 
 constexpr uint_fast32_t duplicate(uint_fast32_t value) {
-  constexpr auto powersOfTen = utils::powersOfTen<uint_fast32_t>();
-  auto nbDigits = utils::getDecimalDigits(value);
-  return value * powersOfTen[nbDigits] + value;
+  auto nbDigits = Digits::getWidth(value);
+  return value * Digits::seeds[2 * nbDigits][nbDigits];
 }
 
 static_assert(duplicate(1) == 11);
@@ -108,13 +108,38 @@ static_assert(sumInvalidInRange({2121212118, 2121212124}) == 0);
 static_assert(sumInvalidInRange({2222, 2728}) ==
               2222 + 2323 + 2424 + 2525 + 2626 + 2727);
 
-int main() {
-  std::string input{};
-  std::getline(std::cin, input);
+uint_fast64_t sumAllInvalid(std::string_view input) {
   uint_fast64_t totalInvalid{0};
   for (auto const invalidCount :
        getRanges(input) | std::views::transform(sumInvalidInRange)) {
     totalInvalid += invalidCount;
   }
+  return totalInvalid;
+}
+
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{
+    "11-22,95-115,998-1012,1188511880-1188511890,222220-222224,"
+    "1698522-1698528,446443-446449,38593856-38593862,565653-565659,"
+    "824824821-824824827,2121212118-2121212124"};
+
+utils::bench::Registration const benchSumInvalid{
+    "day2/sumInvalidInRange",
+    [](size_t scale) {
+      return utils::bench::repeatColumns(example, scale, ",");
+    },
+    [](std::string_view input) -> uint64_t {
+      return sumAllInvalid(utils::bench::getLines(input).front());
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+int main() {
+  std::string input{};
+  std::getline(std::cin, input);
+  auto totalInvalid = sumAllInvalid(input);
   std::cout << "Total invalid stems: " << totalInvalid << '\n';
 }
+#endif
@@ -1,45 +1,146 @@
-#include <algorithm>
-#include <array>
-#include <cassert>
 #include <cstddef>
 #include <cstdint>
-#include <ctime>
+#include <functional>
 #include <generator>
-#include <initializer_list>
 #include <iostream>
-#include <limits>
 #include <numeric>
+#include <stdexcept>
 #include <ranges>
 #include <string>
 #include <string_view>
-#include <sys/types.h>
-#include <type_traits>
-#include <utility>
+#include <thread>
 #include <vector>
 
+#include "utils/bench.hpp"
 #include "utils/decimal.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
 #include "utils/parser.hpp"
+#include "utils/repdigits.hpp"
+
+__extension__ typedef unsigned __int128 u128;
+
+// Sums of the invalid IDs, made of a digit pattern repeated at least twice,
+// for IDs of type T written in base Base. Sums are accumulated in Sum, with
+// std::overflow_error when they do not fit: a Sum twice as wide as T holds
+// the sum of any range, one as wide as T only those of the small ones.
+template <typename T, unsigned Base = 10, typename Sum = u128>
+class RepeatedIds {
+  static_assert(sizeof(Sum) >= sizeof(T));
+  using Digits = utils::RepDigits<T, Base>;
+
+  static constexpr Sum add(Sum a, Sum b) {
+    Sum res;
+    if (__builtin_add_overflow(a, b, &res))
+      throw std::overflow_error{"Sum of invalid IDs overflows"};
+    return res;
+  }
 
-using ui = uint_fast32_t;
+  static constexpr Sum multiply(Sum a, Sum b) {
+    Sum res;
+    if (__builtin_mul_overflow(a, b, &res))
+      throw std::overflow_error{"Sum of invalid IDs overflows"};
+    return res;
+  }
 
-struct Range {
-  ui start;
-  ui end;
-};
+public:
+  struct Range {
+    T start;
+    T end;
+  };
+
+  static constexpr unsigned maxWidth{Digits::maxWidth};
+
+  // Sum of the IDs of range, all of width digits, which repeat a pattern of
+  // patternWidth digits: the multiples of the seed within range
+  static constexpr Sum sumPeriodic(Range range, unsigned width,
+                                   unsigned patternWidth) {
+    auto seed = Digits::seeds[width][patternWidth];
+    T min = range.start / seed + (range.start % seed != 0);
+    T max = range.end / seed;
+    if (min > max)
+      return 0;
+    // One of count and min + max is even, halve it before multiplying
+    Sum count = add(Sum{max} - min, 1);
+    Sum bounds = add(min, max);
+    auto patternSum = count % 2 == 0 ? multiply(count / 2, bounds)
+                                     : multiply(count, bounds / 2);
+    return multiply(patternSum, seed);
+  }
+
+  // Sum of the invalid IDs of range, all of the same width. The IDs
+  // repeating a pattern of p digits with p dividing q also repeat one of q
+  // digits, hence the union over the proper divisors of the width is an
+  // inclusion–exclusion over its squarefree divisors d > 1, weighted by
+  // -mu(d), of the IDs with period width / d.
+  static constexpr Sum sumInvalidSameWidth(Range range) {
+    auto width = Digits::getWidth(range.start);
+    // The added terms count every invalid ID at least once, their sum is
+    // the largest
+    Sum added{0};
+    Sum removed{0};
+    for (auto [patternWidth, isAdded] : Digits::getPeriodTerms(width)) {
+      auto partial = sumPeriodic(range, width, patternWidth);
+      if (isAdded)
+        added = add(added, partial);
+      else
+        removed = add(removed, partial);
+    }
+    return added - removed;
+  }
+
+  // Calls callback on the pieces of range sharing their width, in order
+  static constexpr void splitByWidth(Range range, auto &&callback) {
+    auto start = range.start;
+    auto endWidth = Digits::getWidth(range.end);
+    for (auto width = Digits::getWidth(start); width < endWidth; ++width) {
+      callback(Range{start, Digits::allNines[width]});
+      start = Digits::powers[width];
+    }
+    callback(Range{start, range.end});
+  }
 
-std::generator<Range> getSubRanges(Range range) {
-  static constexpr auto powersOfTen = utils::powersOfTen<ui>();
-  auto nbDigitsStart = utils::getDecimalDigits(range.start);
-  auto nbDigitsEnd = utils::getDecimalDigits(range.end);
-  auto start = range.start;
-  auto end = range.end;
-  while (nbDigitsStart < nbDigitsEnd) {
-    co_yield Range{start, powersOfTen[nbDigitsStart] - 1};
-    start = powersOfTen[nbDigitsStart];
-    nbDigitsStart += 1;
+  // Sum of the invalid IDs of range, split by width
+  static constexpr Sum sumInvalid(Range range) {
+    Sum result{0};
+    splitByWidth(range, [&result](Range piece) {
+      result = add(result, sumInvalidSameWidth(piece));
+    });
+    return result;
   }
-  co_yield Range{start, end};
+};
+
+using Ids = RepeatedIds<uint64_t>;
+using Range = Ids::Range;
+
+static_assert(Ids::sumInvalid({11, 22}) == 33);
+static_assert(Ids::sumInvalid({95, 115}) == 99 + 111);
+static_assert(Ids::sumInvalid({998, 1012}) == 999 + 1010);
+static_assert(Ids::sumInvalid({1188511880, 1188511890}) == 1188511885);
+static_assert(Ids::sumInvalid({222220, 222224}) == 222222);
+static_assert(Ids::sumInvalid({1698522, 1698528}) == 0);
+static_assert(Ids::sumInvalid({446443, 446449}) == 446446);
+static_assert(Ids::sumInvalid({38593856, 38593862}) == 38593859);
+static_assert(Ids::sumInvalid({565653, 565659}) == 565656);
+static_assert(Ids::sumInvalid({824824821, 824824827}) == 824824824);
+static_assert(Ids::sumInvalid({2121212118, 2121212124}) == 2121212121);
+// 111111 repeats patterns of 1, 2 and 3 digits, it is counted once
+static_assert(Ids::sumInvalid({111110, 111112}) == 111111);
+// 1010 and 1111 in base 2
+static_assert(RepeatedIds<uint64_t, 2>::sumInvalid({10, 15}) == 10 + 15);
+
+namespace detail {
+// The 22-digit repunit, beyond 64 bits
+constexpr bool checkWideRepunit() {
+  using WideIds = RepeatedIds<u128>;
+  u128 repunit{0};
+  for (unsigned i{0}; i < 22; ++i)
+    repunit = repunit * 10 + 1;
+  return WideIds::maxWidth == 39 &&
+         WideIds::sumInvalid({repunit - 5, repunit + 5}) == repunit;
 }
+static_assert(checkWideRepunit());
+} // namespace detail
 
 std::generator<Range> getRanges(std::string_view input) {
   utils::Parser parser{input};
@@ -48,158 +149,94 @@ std::generator<Range> getRanges(std::string_view input) {
   }
   std::string_view next{""};
   do {
-    ui start{parser.getUnsignedInt()};
+    auto start = parser.getUnsigned<uint64_t>();
     parser.drop(1); // drop '-'
-    ui end{parser.getUnsignedInt()};
-    for (auto const subRange : getSubRanges(Range{start, end})) {
-      co_yield subRange;
-    }
+    auto end = parser.getUnsigned<uint64_t>();
+    co_yield Range{start, end};
     next = parser.drop(1); // drop ','
   } while (!next.empty());
 }
-namespace detail {
-template <ui nbDigits> constexpr auto buildPrimeDivisors() {
-  auto constexpr callOnDivisor = [](auto cb) constexpr {
-    std::vector<ui> divisors{};
-    for (ui i{2}; i <= nbDigits; ++i) {
-      if (nbDigits % i == 0) {
-        bool isNewDivisor{true};
-        for (ui div : divisors) {
-          if (i % div == 0) {
-            isNewDivisor = false;
-            break;
-          }
-        }
-        if (isNewDivisor) {
-          cb(i);
-          divisors.push_back(i);
-        }
-      }
-    }
-  };
-  constexpr auto nbDivisors = [callOnDivisor] {
-    size_t count{0};
-    callOnDivisor([&count](auto) { count += 1; });
-    return count;
-  }();
-  constexpr auto res =
-      [callOnDivisor]<size_t resSize>(std::integral_constant<size_t, resSize>) {
-        std::array<ui, resSize> result{};
-        size_t index{0};
-        callOnDivisor(
-            [&result, &index](auto divisor) { result[index++] = divisor; });
-        return result;
-      }(std::integral_constant<size_t, nbDivisors>{});
-  return res;
-}
-
-template <ui nbDigits, ui... values> constexpr bool primeDivisorsAre() {
-  constexpr auto res = buildPrimeDivisors<nbDigits>();
-  static_assert(res.size() == sizeof...(values));
-  return buildPrimeDivisors<nbDigits>() == std::array{values...};
-}
-
-static_assert(primeDivisorsAre<6, 2, 3>());
-static_assert(primeDivisorsAre<7, 7>());
-static_assert(primeDivisorsAre<8, 2>());
-static_assert(primeDivisorsAre<9, 3>());
-static_assert(primeDivisorsAre<160, 2, 5>());
-
-template <ui nbDigits>
-static constexpr auto primeDivisors = buildPrimeDivisors<nbDigits>();
-
-} // namespace detail
-
-constexpr std::span<const ui> getPrimeDivisors(ui nbDigits) {
-  assert(nbDigits <= std::numeric_limits<ui>::digits10);
-  auto table = [&]<size_t... Is>(std::index_sequence<Is...>) {
-    std::array res{
-        std::span<ui const>{detail::primeDivisors<static_cast<ui>(Is)>}...};
-    return res;
-  }(std::make_index_sequence<std::numeric_limits<ui>::digits10 + 1>());
-  if (nbDigits < table.size())
-    return table[nbDigits];
-  return std::span<const ui>{};
-}
 
-constexpr ui duplicate(ui value) {
-  constexpr auto powersOfTen = utils::powersOfTen<ui>();
-  auto nbDigits = utils::getDecimalDigits(value);
-  return value * powersOfTen[nbDigits] + value;
+u128 sumAllInvalid(std::string_view input) {
+  u128 totalInvalid{0};
+  for (auto const range : getRanges(input))
+    totalInvalid += Ids::sumInvalid(range);
+  return totalInvalid;
 }
 
-static_assert(duplicate(1) == 11);
-static_assert(duplicate(12) == 1212);
-
-namespace detail {
-constexpr inline ui getSeed(ui totalWidth, ui patternWidth) {
-  static constexpr auto powersOfTen = utils::powersOfTen<ui>();
-  ui result{0};
-  for (ui i{0}; i < totalWidth; i += patternWidth) {
-    result += powersOfTen[i];
+// Comma-separated ranges as a flat list of pieces of a single width
+std::vector<Range> getSubRanges(std::string_view input) {
+  std::vector<Range> res{};
+  utils::Parser parser{input};
+  while (!parser.empty()) {
+    auto start = parser.getUnsigned<uint64_t>();
+    parser.drop(1); // drop '-'
+    auto end = parser.getUnsigned<uint64_t>();
+    parser.drop(1); // drop ','
+    Ids::splitByWidth({start, end},
+                      [&res](Range piece) { res.push_back(piece); });
   }
-  return result;
-}
-
-static_assert(getSeed(9, 3) == 1001001);
-static_assert(getSeed(14, 7) == 10000001);
-
-constexpr auto getHighLow(ui value, ui rangeWidth, ui patternWidth) {
-  static constexpr auto powersOfTen = utils::powersOfTen<ui>();
-  auto lowGroup = value % powersOfTen[rangeWidth - patternWidth];
-  auto highGroup = value / powersOfTen[rangeWidth - patternWidth];
-  return std::make_pair(highGroup, lowGroup);
+  return res;
 }
 
-static_assert(getHighLow(123456789, 9, 3) == std::make_pair(123, 456789));
-
-constexpr uint_fast64_t sumInvalidInRangeForNumDivisor(Range range, ui divisor,
-                                                       bool isFirstDivisor) {
-  static constexpr auto powersOfTen = utils::powersOfTen<ui>();
-  auto rangeWidth = utils::getDecimalDigits(range.start);
-  auto patternWidth = rangeWidth / divisor;
-  auto [startHigh, startLow] =
-      getHighLow(range.start, rangeWidth, patternWidth);
-  auto totalSeed = getSeed(rangeWidth, patternWidth);
-  auto lowerSeed = getSeed(rangeWidth - patternWidth, patternWidth);
-  ui min = startLow > (startHigh * lowerSeed) ? startHigh + 1 : startHigh;
-  auto [endHigh, endLow] = getHighLow(range.end, rangeWidth, patternWidth);
-  ui max = endLow < (endHigh * lowerSeed) ? endHigh - 1 : endHigh;
-  if (min > max)
-    return 0;
-  ui sum = (max - min + 1) * totalSeed * (min + max) / 2;
-  if (!isFirstDivisor) {
-    auto allNines = powersOfTen[patternWidth] - 1;
-    auto allOnes = allNines / 9;
-    for (ui i = allOnes; i <= allNines; i += allOnes) {
-      if (i >= min && i <= max) {
-        sum -= i * totalSeed;
-      }
+// The input is cut between ranges, every thread flattens its part into
+// sub-ranges then reduces them, without any coroutine in the way
+u128 sumAllInvalidParallel(std::string_view input, size_t nbThreads) {
+  auto chunks = utils::splitChunks<','>(input, nbThreads);
+  std::vector<u128> sums(chunks.size());
+  {
+    std::vector<std::jthread> workers{};
+    for (auto [chunk, sum] : std::views::zip(chunks, sums)) {
+      workers.emplace_back([chunk, &sum] {
+        auto subRanges = getSubRanges(chunk);
+        sum = std::transform_reduce(subRanges.begin(), subRanges.end(),
+                                    u128{0}, std::plus{},
+                                    Ids::sumInvalidSameWidth);
+      });
     }
   }
-  return sum;
+  return std::reduce(sums.begin(), sums.end(), u128{0});
 }
-} // namespace detail
 
-constexpr uint_fast64_t sumInvalidInRange(Range const &range) {
-  auto rangeNbDigits = utils::getDecimalDigits(range.start);
-  bool isFirstDivisor{true};
-  ui totalSum{0};
-  for (auto divisor : getPrimeDivisors(rangeNbDigits)) {
-    totalSum +=
-        detail::sumInvalidInRangeForNumDivisor(range, divisor, isFirstDivisor);
-    isFirstDivisor = false;
-  }
-  return totalSum;
-}
-
-int main() {
-  std::string input{};
-  std::getline(std::cin, input);
-  uint_fast64_t totalInvalid{0};
-  for (auto const invalidCount :
-       getRanges(input) | std::views::transform(sumInvalidInRange)) {
-    totalInvalid += invalidCount;
-  }
-  std::cout << "Total invalid ID: " << totalInvalid << '\n';
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{
+    "11-22,95-115,998-1012,1188511880-1188511890,222220-222224,"
+    "1698522-1698528,446443-446449,38593856-38593862,565653-565659,"
+    "824824821-824824827,2121212118-2121212124"};
+
+utils::bench::Registration const benchSumInvalid{
+    "day2_2/sumInvalidInRange",
+    [](size_t scale) {
+      return utils::bench::repeatColumns(example, scale, ",");
+    },
+    [](std::string_view input) -> uint64_t {
+      return static_cast<uint64_t>(
+          sumAllInvalid(utils::bench::getLines(input).front()));
+    }};
+
+utils::bench::Registration const benchParallel{
+    "day2_2/parallel",
+    [](size_t scale) {
+      return utils::bench::repeatColumns(example, scale, ",");
+    },
+    [](std::string_view input) -> uint64_t {
+      return static_cast<uint64_t>(sumAllInvalidParallel(
+          utils::bench::getLines(input).front(), utils::getNbThreads()));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional argument: number of threads, 1 runs the serial generator pipeline
+int main(int argc, char **argv) {
+  auto nbThreads = argc > 1 ? std::stoul(argv[1]) : utils::getNbThreads();
+  // Mapped when stdin is a file, the line is never copied
+  auto input = utils::MappedInput::standardInput().readAll();
+  while (!input.empty() && (input.back() == '\n' || input.back() == '\r'))
+    input.remove_suffix(1);
+  auto totalInvalid = nbThreads <= 1 ? sumAllInvalid(input)
+                                     : sumAllInvalidParallel(input, nbThreads);
+  std::cout << "Total invalid ID: " << utils::toDecimal(totalInvalid) << '\n';
 }
+#endif
@@ -1,18 +1,21 @@
+#include "utils/bench.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
+#include "utils/random.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <generator>
 #include <iostream>
 #include <ranges>
+#include <string>
 #include <string_view>
 
-std::generator<std::string_view> getBatteryLines() {
-  std::string line;
-  while (std::getline(std::cin, line))
-    co_yield line;
-}
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
 
-size_t getMaxJoltage(std::string_view input) {
+constexpr size_t getMaxJoltage(std::string_view input) {
   char head = input[0];
   char next = input[1];
   for (auto slice : input | std::views::slide(2)) {
@@ -28,10 +31,143 @@ size_t getMaxJoltage(std::string_view input) {
   return static_cast<size_t>(10 * (head - '0') + (next - '0'));
 }
 
-int main() {
-  size_t sum = std::ranges::fold_left(getBatteryLines() |
-                                          std::views::transform(getMaxJoltage),
-                                      size_t{0}, std::plus<>{});
+namespace detail {
+constexpr char maxDigitScalar(std::string_view digits) {
+  return std::ranges::max(digits);
+}
+
+#if defined(__AVX2__)
+inline char maxDigitSimd(std::string_view digits) {
+  size_t pos{0};
+  auto acc = _mm256_setzero_si256();
+  for (; pos + 32 <= digits.size(); pos += 32) {
+    auto chunk = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const *>(digits.data() + pos));
+    acc = _mm256_max_epu8(acc, chunk);
+  }
+  // Folds the 32 lanes in halves down to the first one
+  auto res = _mm_max_epu8(_mm256_castsi256_si128(acc),
+                          _mm256_extracti128_si256(acc, 1));
+  res = _mm_max_epu8(res, _mm_srli_si128(res, 8));
+  res = _mm_max_epu8(res, _mm_srli_si128(res, 4));
+  res = _mm_max_epu8(res, _mm_srli_si128(res, 2));
+  res = _mm_max_epu8(res, _mm_srli_si128(res, 1));
+  auto max = static_cast<char>(_mm_cvtsi128_si32(res) & 0xFF);
+  for (; pos < digits.size(); ++pos)
+    max = std::max(max, digits[pos]);
+  return max;
+}
+#endif
+
+// Largest digit of a non-empty run of digits
+constexpr char maxDigit(std::string_view digits) {
+#if defined(__AVX2__)
+  if !consteval {
+    return maxDigitSimd(digits);
+  }
+#endif
+  return maxDigitScalar(digits);
+}
+} // namespace detail
+
+// Same result as getMaxJoltage, in two max reductions: the tens digit is the
+// first largest one but the last, the units digit the largest after it
+constexpr size_t getMaxJoltageTwoPass(std::string_view input) {
+  auto head = detail::maxDigit(input.substr(0, input.size() - 1));
+  auto next = detail::maxDigit(input.substr(input.find(head) + 1));
+  return static_cast<size_t>(10 * (head - '0') + (next - '0'));
+}
+
+namespace detail {
+constexpr bool checkTwoPassOnRandomLines() {
+  utils::Random random{3};
+  for (size_t i{0}; i < 200; ++i) {
+    std::string line(random.between(2, 100), '0');
+    for (auto &digit : line)
+      digit = static_cast<char>('1' + random.between(0, 8));
+    if (getMaxJoltageTwoPass(line) != getMaxJoltage(line))
+      return false;
+  }
+  return true;
+}
+static_assert(checkTwoPassOnRandomLines());
+static_assert(getMaxJoltageTwoPass("818181911112111") == 92);
+} // namespace detail
+
+size_t sumMaxJoltagesParallel(std::string_view input, size_t nbThreads) {
+  return utils::foldLinesParallel(input, nbThreads, size_t{0}, std::plus<>{},
+                                  getMaxJoltageTwoPass);
+}
+
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{"987654321111111\n"
+                                   "811111111111119\n"
+                                   "234234234234278\n"
+                                   "818181911112111"};
+
+utils::bench::Registration const benchMaxJoltage{
+    "day3/getMaxJoltage",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return std::ranges::fold_left(
+          utils::bench::getLines(input) |
+              std::views::transform(getMaxJoltage),
+          size_t{0}, std::plus<>{});
+    }};
+
+utils::bench::Registration const benchTwoPass{
+    "day3/getMaxJoltageTwoPass",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return std::ranges::fold_left(
+          utils::bench::getLines(input) |
+              std::views::transform(getMaxJoltageTwoPass),
+          size_t{0}, std::plus<>{});
+    }};
+
+// The static_assert only reaches the scalar kernel, the SIMD one is checked
+// here on lines spanning several 32-byte blocks, with a ragged tail
+utils::bench::CheckRegistration const checkTwoPass{
+    "day3/getMaxJoltageTwoPass", [] {
+      utils::Random random{5};
+      for (size_t i{0}; i < 2000; ++i) {
+        std::string line(random.between(2, 200), '0');
+        for (auto &digit : line)
+          digit = static_cast<char>('1' + random.between(0, 8));
+        if (getMaxJoltageTwoPass(line) != getMaxJoltage(line))
+          return false;
+#if defined(__AVX2__)
+        if (detail::maxDigitSimd(line) != detail::maxDigitScalar(line))
+          return false;
+#endif
+      }
+      return true;
+    }};
+
+utils::bench::Registration const benchParallel{
+    "day3/parallel",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return sumMaxJoltagesParallel(input, utils::getNbThreads());
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional argument: number of threads, 1 folds the lines as they are read
+int main(int argc, char **argv) {
+  auto nbThreads = argc > 1 ? std::stoul(argv[1]) : utils::getNbThreads();
+  size_t sum{0};
+  if (nbThreads <= 1) {
+    sum = std::ranges::fold_left(
+        utils::getLines() | std::views::transform(getMaxJoltageTwoPass),
+        size_t{0}, std::plus<>{});
+  } else {
+    sum = sumMaxJoltagesParallel(
+        utils::MappedInput::standardInput().readAll(), nbThreads);
+  }
   std::cout << "Sum of max joltages: " << sum << '\n';
   return 0;
 }
+#endif
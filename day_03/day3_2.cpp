@@ -1,20 +1,21 @@
+#include "utils/bench.hpp"
+#include "utils/bigint.hpp"
 #include "utils/decimal.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
 #include <algorithm>
+#include <array>
 #include <cstddef>
 #include <functional>
 #include <generator>
 #include <iostream>
 #include <iterator>
+#include <limits>
 #include <ranges>
+#include <string>
 #include <string_view>
 #include <vector>
 
-std::generator<std::string_view> getBatteryLines() {
-  std::string line;
-  while (std::getline(std::cin, line))
-    co_yield line;
-}
-
 template <size_t NBattery>
 constexpr size_t getMaxJoltage(std::string_view const input) {
   std::array<char, NBattery> digits{};
@@ -50,10 +51,162 @@ constexpr size_t getMaxJoltage(std::string_view const input) {
   return joltage;
 }
 
-int main() {
-  size_t sum = std::ranges::fold_left(
-      getBatteryLines() | std::views::transform(getMaxJoltage<12>), size_t{0},
-      std::plus<>{});
+// Largest subsequence of nbBattery digits of input, greedily kept on a
+// monotonic stack: a digit pops the smaller ones before it as long as enough
+// digits remain to fill the selection. Linear in the line length.
+constexpr std::string selectMaxDigits(std::string_view const input,
+                                      size_t nbBattery) {
+  if (input.size() <= nbBattery)
+    return std::string{input};
+  auto nbDroppable = input.size() - nbBattery;
+  std::string stack{};
+  stack.reserve(input.size());
+  for (char value : input) {
+    while (nbDroppable > 0 && !stack.empty() && stack.back() < value) {
+      stack.pop_back();
+      nbDroppable -= 1;
+    }
+    stack.push_back(value);
+  }
+  stack.resize(nbBattery);
+  return stack;
+}
+
+// Runtime battery count, the result has to fit in a size_t. The usual counts
+// go through the unrolled templates.
+constexpr size_t getMaxJoltage(std::string_view const input,
+                               size_t nbBattery) {
+  if (input.size() >= nbBattery) {
+    switch (nbBattery) {
+    case 2:
+      return getMaxJoltage<2>(input);
+    case 12:
+      return getMaxJoltage<12>(input);
+    default:
+      break;
+    }
+  }
+  size_t joltage{0};
+  for (char c : selectMaxDigits(input, nbBattery))
+    utils::addLowDigit(joltage, c);
+  return joltage;
+}
+
+namespace detail {
+constexpr std::array<std::string_view, 4> exampleLines{
+    "987654321111111", "811111111111119", "234234234234278",
+    "818181911112111"};
+
+constexpr bool checkSelectMatchesTemplate() {
+  return std::ranges::all_of(exampleLines, [](std::string_view line) {
+    auto fromTemplate = utils::toDecimal(getMaxJoltage<12>(line));
+    return getMaxJoltage(line, 2) == getMaxJoltage<2>(line) &&
+           getMaxJoltage(line, 5) == getMaxJoltage<5>(line) &&
+           selectMaxDigits(line, 12) == fromTemplate;
+  });
+}
+static_assert(checkSelectMatchesTemplate());
+static_assert(getMaxJoltage(exampleLines[3], 12) == 888911112111);
+static_assert(selectMaxDigits("123", 5) == "123");
+} // namespace detail
+
+// Sum of the joltages as a decimal string, whatever their number of digits.
+// A joltage of up to 19 digits fits in a size_t, but their sum over a few
+// lines does not: it is folded on 128 bits, enough for 2^64 lines.
+constexpr std::string sumMaxJoltages(std::ranges::input_range auto &&lines,
+                                     size_t nbBattery) {
+  if (nbBattery <= std::numeric_limits<size_t>::digits10) {
+    return utils::toDecimal(std::ranges::fold_left(
+        lines | std::views::transform([nbBattery](std::string_view line) {
+          return getMaxJoltage(line, nbBattery);
+        }),
+        utils::uint128{0}, std::plus<>{}));
+  }
+  std::string sum{"0"};
+  for (std::string_view line : lines)
+    utils::addDecimal(sum, selectMaxDigits(line, nbBattery));
+  return sum;
+}
+
+namespace detail {
+// Two joltages of 19 digits already overflow 64 bits
+constexpr std::array<std::string_view, 2> nineLines{"99999999999999999999",
+                                                    "99999999999999999999"};
+static_assert(sumMaxJoltages(nineLines, 19) == "19999999999999999998");
+static_assert(sumMaxJoltages(exampleLines, 12) == "3121910778619");
+} // namespace detail
+
+// Same sum with the lines shared out between nbThreads threads, folded on
+// 128 bits as well
+std::string sumMaxJoltagesParallel(std::string_view input, size_t nbBattery,
+                                   size_t nbThreads) {
+  if (nbBattery <= std::numeric_limits<size_t>::digits10) {
+    return utils::toDecimal(utils::foldLinesParallel(
+        input, nbThreads, utils::uint128{0}, std::plus<>{},
+        [nbBattery](std::string_view line) {
+          return getMaxJoltage(line, nbBattery);
+        }));
+  }
+  return utils::foldLinesParallel(
+      input, nbThreads, std::string{"0"},
+      [](std::string sum, std::string const &digits) {
+        utils::addDecimal(sum, digits);
+        return sum;
+      },
+      [nbBattery](std::string_view line) {
+        return selectMaxDigits(line, nbBattery);
+      });
+}
+
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{"987654321111111\n"
+                                   "811111111111119\n"
+                                   "234234234234278\n"
+                                   "818181911112111"};
+
+utils::bench::Registration const benchMaxJoltage{
+    "day3_2/getMaxJoltage<12>",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return std::ranges::fold_left(
+          utils::bench::getLines(input) |
+              std::views::transform(getMaxJoltage<12>),
+          size_t{0}, std::plus<>{});
+    }};
+
+utils::bench::Registration const benchSelectMaxDigits{
+    "day3_2/selectMaxDigits<1000>",
+    [](size_t scale) {
+      return utils::bench::repeatColumns(example, scale * 100, "");
+    },
+    [](std::string_view input) -> uint64_t {
+      return sumMaxJoltages(utils::bench::getLines(input), 1000).size();
+    }};
+
+utils::bench::Registration const benchParallel{
+    "day3_2/parallel<1000>",
+    [](size_t scale) {
+      return utils::bench::repeatColumns(example, scale * 100, "");
+    },
+    [](std::string_view input) -> uint64_t {
+      return sumMaxJoltagesParallel(input, 1000, utils::getNbThreads()).size();
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional arguments: number of batteries to turn on per line, 12 by
+// default, then number of threads, 1 folds the lines as they are read
+int main(int argc, char **argv) {
+  auto nbBattery = argc > 1 ? std::stoul(argv[1]) : size_t{12};
+  auto nbThreads = argc > 2 ? std::stoul(argv[2]) : utils::getNbThreads();
+  auto sum = nbThreads <= 1
+                 ? sumMaxJoltages(utils::getLines(), nbBattery)
+                 : sumMaxJoltagesParallel(
+                       utils::MappedInput::standardInput().readAll(),
+                       nbBattery, nbThreads);
   std::cout << "Sum of max joltages: " << sum << '\n';
   return 0;
 }
+#endif
@@ -0,0 +1,239 @@
+#ifndef DAY_04_BITGRID_HPP
+#define DAY_04_BITGRID_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/scan.hpp"
+
+// Grid of rolls packed 64 cells per word: bit i of word j of a row is
+// column 64 * j + i. Neighbour counts are evaluated a word at a time with
+// bit-sliced adders over three rows, so a 100k x 100k grid takes 1.25 GB.
+class BitGrid {
+public:
+  static constexpr size_t wordBits{64};
+
+  enum struct PeelMode {
+    // Every round evaluates the whole grid
+    FullRounds,
+    // A round only evaluates words next to a removal of the previous round
+    Frontier
+  };
+
+  constexpr void addRow(std::string_view line) {
+    if (nbRows == 0)
+      wordsPerRow = (line.size() + wordBits - 1) / wordBits;
+    packRow(line, words);
+    nbRows += 1;
+  }
+
+  // Appends the words of line to res
+  static constexpr void packRow(std::string_view line,
+                                std::vector<uint64_t> &res) {
+    size_t pos{0};
+    for (; pos + utils::scanBlockSize <= line.size();
+         pos += utils::scanBlockSize) {
+      res.push_back(utils::matchMask<'@'>(line.data() + pos));
+    }
+    if (pos < line.size()) {
+      res.push_back(utils::detail::matchMaskScalar<'@'>(line.data() + pos,
+                                                        line.size() - pos));
+    }
+  }
+
+  constexpr size_t count() const {
+    size_t res{0};
+    for (auto word : words)
+      res += static_cast<size_t>(std::popcount(word));
+    return res;
+  }
+
+  // Number of rolls with fewer than 4 neighbouring rolls
+  constexpr size_t countAccessible() const {
+    size_t res{0};
+    for (size_t r{0}; r < nbRows; ++r) {
+      for (size_t j{0}; j < wordsPerRow; ++j) {
+        auto removable = accessible(getRow(r - 1), getRow(r), getRow(r + 1), j);
+        res += static_cast<size_t>(std::popcount(removable));
+      }
+    }
+    return res;
+  }
+
+  // Removes the accessible rolls in simultaneous rounds until none is left.
+  // The result does not depend on the removal order: what remains is the
+  // largest set of rolls that all have at least 4 neighbours in it.
+  constexpr size_t peel(PeelMode mode = PeelMode::Frontier) {
+    auto maskWords = (wordsPerRow + wordBits - 1) / wordBits;
+    // Bit j of a row mask: word j of the row lost rolls in the round
+    std::vector<uint64_t> changed(nbRows * maskWords, ~uint64_t{0});
+    std::vector<uint64_t> nextChanged(nbRows * maskWords, 0);
+    std::vector<uint64_t> candidates(maskWords);
+    // Removals of a row are applied once the next row has been evaluated,
+    // so that every evaluation of a round sees the grid of its start.
+    std::vector<std::pair<size_t, uint64_t>> pending{}, current{};
+    auto rowMask = [&](std::vector<uint64_t> const &masks, size_t r) {
+      return r < nbRows ? std::span{masks}.subspan(r * maskWords, maskWords)
+                        : std::span<uint64_t const>{};
+    };
+    auto apply = [&](size_t r) {
+      for (auto [j, removed] : pending) {
+        words[r * wordsPerRow + j] &= ~removed;
+        nextChanged[r * maskWords + j / wordBits] |= uint64_t{1}
+                                                     << (j % wordBits);
+      }
+      pending.clear();
+    };
+
+    size_t nbRemoved{0};
+    for (bool progress{true}; progress;) {
+      progress = false;
+      for (size_t r{0}; r < nbRows; ++r) {
+        if (mode == PeelMode::Frontier)
+          getCandidates(rowMask(changed, r - 1), rowMask(changed, r),
+                        rowMask(changed, r + 1), candidates);
+        else
+          std::ranges::fill(candidates, ~uint64_t{0});
+        auto above = getRow(r - 1);
+        auto row = getRow(r);
+        auto below = getRow(r + 1);
+        for (size_t k{0}; k < maskWords; ++k) {
+          for (auto mask = candidates[k]; mask != 0; mask &= mask - 1) {
+            auto j = k * wordBits + static_cast<size_t>(std::countr_zero(mask));
+            if (j >= wordsPerRow)
+              break;
+            auto removed = accessible(above, row, below, j);
+            if (removed != 0) {
+              current.emplace_back(j, removed);
+              nbRemoved += static_cast<size_t>(std::popcount(removed));
+            }
+          }
+        }
+        if (r != 0)
+          apply(r - 1);
+        std::swap(pending, current);
+        progress = progress || !pending.empty();
+      }
+      if (nbRows != 0)
+        apply(nbRows - 1);
+      std::swap(changed, nextChanged);
+      std::ranges::fill(nextChanged, 0);
+    }
+    return nbRemoved;
+  }
+
+  static constexpr uint64_t wordAt(std::span<uint64_t const> row, size_t j) {
+    return j < row.size() ? row[j] : 0;
+  }
+
+  // Cells whose west / east neighbour holds a roll
+  static constexpr uint64_t west(std::span<uint64_t const> row, size_t j) {
+    return (wordAt(row, j) << 1) | (j == 0 ? 0 : wordAt(row, j - 1) >> 63);
+  }
+  static constexpr uint64_t east(std::span<uint64_t const> row, size_t j) {
+    return (wordAt(row, j) >> 1) | (wordAt(row, j + 1) << 63);
+  }
+
+  // Rolls of word j of row with fewer than 4 neighbours, an empty span
+  // stands for a row of empty cells. The 8 neighbour
+  // bits of every cell go through a tree of full adders; the sum is
+  // o + 2 * (c1 + c2 + c3 + c4), which is at least 4 when two carries are.
+  static constexpr uint64_t accessible(std::span<uint64_t const> above,
+                                       std::span<uint64_t const> row,
+                                       std::span<uint64_t const> below,
+                                       size_t j) {
+    auto fullAdder = [](uint64_t a, uint64_t b, uint64_t c) {
+      return std::pair{a ^ b ^ c, (a & b) | (c & (a ^ b))};
+    };
+    auto [s1, c1] =
+        fullAdder(west(above, j), wordAt(above, j), east(above, j));
+    auto [s2, c2] =
+        fullAdder(west(below, j), wordAt(below, j), east(below, j));
+    auto westRow = west(row, j);
+    auto eastRow = east(row, j);
+    auto s3 = westRow ^ eastRow;
+    auto c3 = westRow & eastRow;
+    auto c4 = fullAdder(s1, s2, s3).second;
+    auto atLeastFour = ((c1 | c2) & (c3 | c4)) | (c1 & c2) | (c3 & c4);
+    return wordAt(row, j) & ~atLeastFour;
+  }
+
+private:
+  // Row r, or an empty row outside of the grid
+  constexpr std::span<uint64_t const> getRow(size_t r) const {
+    if (r >= nbRows)
+      return {};
+    return std::span{words}.subspan(r * wordsPerRow, wordsPerRow);
+  }
+
+  // Words to evaluate in a row: those next to a word that changed in the
+  // row or the ones around it
+  static constexpr void getCandidates(std::span<uint64_t const> above,
+                                      std::span<uint64_t const> row,
+                                      std::span<uint64_t const> below,
+                                      std::vector<uint64_t> &res) {
+    auto changedAround = [&](size_t k) {
+      return wordAt(above, k) | wordAt(row, k) | wordAt(below, k);
+    };
+    for (size_t k{0}; k < res.size(); ++k) {
+      auto mask = changedAround(k);
+      res[k] = mask | (mask << 1) | (mask >> 1) |
+               (k == 0 ? 0 : changedAround(k - 1) >> 63) |
+               (changedAround(k + 1) << 63);
+    }
+  }
+
+  size_t wordsPerRow{0};
+  size_t nbRows{0};
+  std::vector<uint64_t> words{};
+};
+
+// Accessible rolls of a grid streamed row by row. Only the last three packed
+// rows are kept, so memory is O(width) however tall the grid is.
+class AccessibleCounter {
+public:
+  // Adds the next row, returns the accessible rolls of the previous row
+  // which is now complete
+  constexpr size_t push(std::string_view line) {
+    rows[2].clear();
+    BitGrid::packRow(line, rows[2]);
+    size_t res{nbRows == 0 ? 0 : countMiddle()};
+    nbRows += 1;
+    std::ranges::rotate(rows, rows.begin() + 1);
+    return res;
+  }
+
+  // Returns the accessible rolls of the last row
+  constexpr size_t finish() {
+    if (nbRows == 0)
+      return 0;
+    rows[2].clear();
+    auto res = countMiddle();
+    *this = {};
+    return res;
+  }
+
+private:
+  constexpr size_t countMiddle() const {
+    auto const &[above, middle, below] = rows;
+    size_t res{0};
+    for (size_t j{0}; j < middle.size(); ++j) {
+      res += static_cast<size_t>(
+          std::popcount(BitGrid::accessible(above, middle, below, j)));
+    }
+    return res;
+  }
+
+  // Row before the middle one, the middle one, and the last pushed
+  std::array<std::vector<uint64_t>, 3> rows{};
+  size_t nbRows{0};
+};
+
+#endif // DAY_04_BITGRID_HPP
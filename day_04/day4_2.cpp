@@ -1,124 +1,235 @@
+#include "bitgrid.hpp"
+#include "utils/bench.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
 #include <algorithm>
 #include <array>
-#include <deque>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
 #include <generator>
 #include <iostream>
+#include <iterator>
 #include <ranges>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <vector>
 
-class Graph {
+// Grid of rolls with a border of empty cells, so that every cell of the
+// puzzle has its 8 neighbours at fixed offsets. A roll cell holds the number
+// of rolls around it, which peeling keeps up to date.
+class RollGrid {
 public:
-  using handle_t = size_t;
-  struct Cell {
-    bool active{true};
-    std::vector<handle_t> neighbors;
-    void constexpr connect(handle_t node) { neighbors.push_back(node); }
-  };
-  constexpr Graph() {
-    // Add sentinel
-    cells.push_back({});
+  static constexpr uint8_t emptyCell{0xFF};
+
+  constexpr void addRow(std::ranges::sized_range auto &&line) {
+    if (cells.empty()) {
+      width = std::ranges::size(line) + 2;
+      cells.assign(width, emptyCell);
+    }
+    cells.push_back(emptyCell);
+    std::ranges::transform(line, std::back_inserter(cells), [](char c) {
+      return c == '@' ? uint8_t{0} : emptyCell;
+    });
+    cells.push_back(emptyCell);
   }
 
-  constexpr handle_t addNode() {
-    auto res = cells.size();
-    cells.push_back({});
-    return res;
+  // Removes every roll that has, or ends up with, fewer than 4 neighbours.
+  // Returns the number of removed rolls.
+  constexpr size_t peel() {
+    if (cells.empty())
+      return 0;
+    addBottomBorder();
+    std::vector<size_t> toRemove{};
+    for (size_t idx{width}; idx < cells.size() - width; ++idx) {
+      if (cells[idx] == emptyCell)
+        continue;
+      countNeighbors(idx);
+      if (cells[idx] < 4)
+        toRemove.push_back(idx);
+    }
+    // A roll is queued once, when its count first drops below 4
+    size_t nbRemoved{0};
+    while (!toRemove.empty()) {
+      auto idx = toRemove.back();
+      toRemove.pop_back();
+      cells[idx] = emptyCell;
+      nbRemoved += 1;
+      for (auto offset : getOffsets()) {
+        if (decrement(neighbor(idx, offset)))
+          toRemove.push_back(neighbor(idx, offset));
+      }
+    }
+    return nbRemoved;
   }
 
-  auto constexpr getNodes(auto &filter) const {
-    return std::views::iota(size_t{1}, cells.size()) |
-           std::views::filter([&filter, this](handle_t value) {
-             return cells[value].active && filter(value);
-           });
+  // Same result as peel(), with the rows split in bands peeled by their own
+  // thread. A thread only writes the cells of its band: the decrements a
+  // removal owes to the row just outside of the band are posted to the
+  // neighbouring band, which applies them between two rounds. Rounds go on
+  // until one ends with no decrement posted.
+  size_t peelParallel(size_t nbThreads) {
+    if (cells.empty())
+      return 0;
+    addBottomBorder();
+    auto nbRows = cells.size() / width - 2;
+    nbThreads = std::clamp(nbThreads, size_t{1}, nbRows);
+    struct Band {
+      size_t firstRow;
+      size_t endRow;
+      std::vector<size_t> toRemove{};
+      // Decrements for the band above and the band below
+      std::array<std::vector<size_t>, 2> outbox{};
+      size_t nbRemoved{0};
+    };
+    std::vector<Band> bands{};
+    for (size_t b{0}; b < nbThreads; ++b) {
+      bands.push_back({1 + b * nbRows / nbThreads,
+                       1 + (b + 1) * nbRows / nbThreads});
+    }
+    auto countRow = [this](size_t row) {
+      for (size_t idx{row * width}; idx < (row + 1) * width; ++idx) {
+        if (cells[idx] != emptyCell)
+          countNeighbors(idx);
+      }
+    };
+
+    // Edge rows of a band read the edge rows of the next bands, they are
+    // counted once the inner rows are done
+    {
+      std::vector<std::jthread> workers{};
+      for (auto const &band : bands) {
+        workers.emplace_back([&band, &countRow] {
+          for (auto row{band.firstRow + 1}; row + 1 < band.endRow; ++row)
+            countRow(row);
+        });
+      }
+    }
+    for (auto const &band : bands) {
+      countRow(band.firstRow);
+      if (band.endRow - 1 != band.firstRow)
+        countRow(band.endRow - 1);
+    }
+
+    std::atomic<size_t> nbPosted{0};
+    bool quiescent{false};
+    std::barrier sync{
+        static_cast<std::ptrdiff_t>(nbThreads),
+        [&]() noexcept { quiescent = nbPosted.exchange(0) == 0; }};
+    auto peelBand = [&](size_t b) {
+      auto &band = bands[b];
+      auto firstCell = band.firstRow * width;
+      auto endCell = band.endRow * width;
+      for (auto idx{firstCell}; idx < endCell; ++idx) {
+        if (cells[idx] < 4)
+          band.toRemove.push_back(idx);
+      }
+      while (true) {
+        while (!band.toRemove.empty()) {
+          auto idx = band.toRemove.back();
+          band.toRemove.pop_back();
+          cells[idx] = emptyCell;
+          band.nbRemoved += 1;
+          for (auto offset : getOffsets()) {
+            auto target = neighbor(idx, offset);
+            if (target < firstCell) {
+              if (b != 0)
+                band.outbox[0].push_back(target);
+            } else if (target >= endCell) {
+              if (b + 1 != bands.size())
+                band.outbox[1].push_back(target);
+            } else if (decrement(target)) {
+              band.toRemove.push_back(target);
+            }
+          }
+        }
+        nbPosted += band.outbox[0].size() + band.outbox[1].size();
+        sync.arrive_and_wait();
+        if (quiescent)
+          return;
+        auto receive = [&](std::vector<size_t> const &inbox) {
+          for (auto target : inbox) {
+            if (decrement(target))
+              band.toRemove.push_back(target);
+          }
+        };
+        if (b != 0)
+          receive(bands[b - 1].outbox[1]);
+        if (b + 1 != bands.size())
+          receive(bands[b + 1].outbox[0]);
+        sync.arrive_and_wait();
+        band.outbox[0].clear();
+        band.outbox[1].clear();
+      }
+    };
+    {
+      std::vector<std::jthread> workers{};
+      for (size_t b{0}; b < nbThreads; ++b)
+        workers.emplace_back(peelBand, b);
+    }
+    return std::ranges::fold_left(bands, size_t{0},
+                                  [](size_t acc, Band const &band) {
+                                    return acc + band.nbRemoved;
+                                  });
   }
 
-  auto constexpr getNeighbors(handle_t handle) {
-    return cells[handle].neighbors |
-           std::views::filter(
-               [this](handle_t handle) { return cells[handle].active; });
+private:
+  static constexpr size_t neighbor(size_t idx, std::ptrdiff_t offset) {
+    return static_cast<size_t>(static_cast<std::ptrdiff_t>(idx) + offset);
   }
 
-  constexpr size_t getNumNeighbors(handle_t node) {
-    return std::ranges::fold_left(
-        getNeighbors(node) | std::views::transform([](auto) { return 1; }), 0,
-        std::plus<>{});
+  constexpr std::array<std::ptrdiff_t, 8> getOffsets() const {
+    auto w = static_cast<std::ptrdiff_t>(width);
+    return {-w - 1, -w, -w + 1, -1, 1, w - 1, w, w + 1};
   }
 
-  constexpr void connect(handle_t node0, handle_t node1) {
-    if (0 == node0 || 0 == node1)
-      return;
-    cells[node0].connect(node1);
-    cells[node1].connect(node0);
+  constexpr void addBottomBorder() {
+    cells.resize(cells.size() + width, emptyCell);
   }
 
-  constexpr void erase(handle_t node) {
-    cells[node].active = false;
-    nbDeleted += 1;
+  constexpr void countNeighbors(size_t idx) {
+    for (auto offset : getOffsets())
+      cells[idx] += cells[neighbor(idx, offset)] != emptyCell;
   }
 
-  constexpr size_t size() const { return cells.size() - nbDeleted - 1; }
+  // Returns true when the roll at idx is left with 3 neighbours
+  constexpr bool decrement(size_t idx) {
+    auto &count = cells[idx];
+    if (count == emptyCell)
+      return false;
+    return count-- == 4;
+  }
 
-private:
-  std::vector<Cell> cells{};
-  size_t nbDeleted{0};
+  size_t width{0};
+  std::vector<uint8_t> cells{};
 };
 
-// Add one extraLine
-std::generator<std::string_view> getLines() {
-  std::string line{};
-  while (std::getline(std::cin, line)) {
-    co_yield line;
-  }
+constexpr size_t getAvailables(std::ranges::view auto &&lines) {
+  RollGrid grid{};
+  for (auto line : lines)
+    grid.addRow(line);
+  return grid.peel();
 }
 
-constexpr size_t getAvailables(std::ranges::view auto &&lines) {
-  Graph myGraph{};
-  std::vector<Graph::handle_t> oldCells{}, cells{};
-  size_t size{0};
-  for (auto line : lines) {
-    if (oldCells.size() == 0) {
-      oldCells.resize(line.size());
-      cells.resize(line.size());
-      size = line.size();
-    }
-    std::fill_n(begin(cells), oldCells.size(), Graph::handle_t{});
-    for (auto [idx, node] : line | std::views::transform([&myGraph](char c) {
-                              return c == '@' ? myGraph.addNode()
-                                              : Graph::handle_t{};
-                            }) | std::views::enumerate) {
-      cells[idx] = node;
-      if (idx) {
-        myGraph.connect(node, cells[idx - 1]);
-        myGraph.connect(node, oldCells[idx - 1]);
-      }
-      myGraph.connect(node, oldCells[idx]);
-      if (static_cast<size_t>(idx) + 1 < size) {
-        myGraph.connect(node, oldCells[idx + 1]);
-      }
-    }
-    std::swap(oldCells, cells);
-  }
-  auto removeFilter = [&myGraph](auto handle) {
-    return myGraph.getNumNeighbors(handle) < 4;
-  };
-  auto toRemove = std::ranges::to<std::vector>(myGraph.getNodes(removeFilter));
-  size_t sum{0};
-  while (!toRemove.empty()) {
-    auto handle = toRemove.back();
-    auto neighborList = myGraph.getNeighbors(handle);
-    myGraph.erase(handle);
-    sum += 1;
-    toRemove.pop_back();
-    for (auto n : neighborList | std::views::filter([&myGraph](auto handle) {
-                    return myGraph.getNumNeighbors(handle) == 3;
-                  })) {
-      toRemove.push_back(n);
-    }
-  }
-  return sum;
+size_t getAvailablesParallel(std::ranges::view auto &&lines,
+                             size_t nbThreads) {
+  RollGrid grid{};
+  for (auto line : lines)
+    grid.addRow(line);
+  return grid.peelParallel(nbThreads);
+}
+
+constexpr size_t
+getAvailablesBitGrid(std::ranges::view auto &&lines,
+                     BitGrid::PeelMode mode = BitGrid::PeelMode::Frontier) {
+  BitGrid grid{};
+  for (auto line : lines)
+    grid.addRow(std::string_view{line});
+  return grid.peel(mode);
 }
+
 constexpr std::string_view example{"..@@.@@@@."
                                    "@@@.@.@.@@"
                                    "@@@@@.@.@@"
@@ -130,8 +241,51 @@ constexpr std::string_view example{"..@@.@@@@."
                                    ".@@@@@@@@."
                                    "@.@.@@@.@."};
 static_assert(getAvailables(example | std::views::chunk(10)) == 43);
+static_assert(getAvailablesBitGrid(example | std::views::chunk(10)) == 43);
+static_assert(getAvailablesBitGrid(example | std::views::chunk(10),
+                                   BitGrid::PeelMode::FullRounds) == 43);
+
+#ifdef AOC_BENCH
+namespace {
+std::string makeGrid(size_t scale) {
+  std::string grid{};
+  for (auto row : example | std::views::chunk(10)) {
+    std::ranges::copy(row, std::back_inserter(grid));
+    grid += '\n';
+  }
+  return utils::bench::tileGrid(grid, scale);
+}
+
+utils::bench::Registration const benchAvailables{
+    "day4_2/getAvailables", makeGrid, [](std::string_view input) -> uint64_t {
+      return getAvailables(utils::bench::getLines(input));
+    }};
+utils::bench::Registration const benchAvailablesParallel{
+    "day4_2/getAvailablesParallel", makeGrid,
+    [](std::string_view input) -> uint64_t {
+      return getAvailablesParallel(utils::bench::getLines(input),
+                                   utils::getNbThreads());
+    }};
+utils::bench::Registration const benchBitGridFull{
+    "day4_2/bitGridFullRounds", makeGrid,
+    [](std::string_view input) -> uint64_t {
+      return getAvailablesBitGrid(utils::bench::getLines(input),
+                                  BitGrid::PeelMode::FullRounds);
+    }};
+utils::bench::Registration const benchBitGridFrontier{
+    "day4_2/bitGridFrontier", makeGrid, [](std::string_view input) -> uint64_t {
+      return getAvailablesBitGrid(utils::bench::getLines(input));
+    }};
+} // namespace
 
-int main() {
-  auto sum = getAvailables(getLines());
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional argument: number of threads peeling bands of the grid, the
+// bitboard engine runs when there is none
+int main(int argc, char **argv) {
+  auto sum = argc > 1 ? getAvailablesParallel(utils::getLines(),
+                                              std::stoul(argv[1]))
+                      : getAvailablesBitGrid(utils::getLines());
   std::cout << "Nb movable rolls: " << sum << '\n';
 }
+#endif
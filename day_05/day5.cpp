@@ -1,119 +1,63 @@
+#include "rangeset.hpp"
+#include "utils/bench.hpp"
+#include "utils/io.hpp"
 #include "utils/parser.hpp"
 #include <algorithm>
 #include <cstddef>
-#include <functional>
+#include <cstdint>
 #include <generator>
 #include <iostream>
 #include <iterator>
-#include <map>
 #include <ranges>
 #include <string>
 #include <string_view>
-#include <utility>
-
-using Range = std::pair<size_t, size_t>;
+#include <vector>
 
+// Lines up to the next blank one
 std::generator<std::string_view> getLines() {
-  std::string res{};
-  while (std::getline(std::cin, res)) {
-    if (res.empty())
+  for (auto line : utils::getLines()) {
+    if (line.empty())
       co_return;
-    co_yield res;
+    co_yield line;
   }
 }
 
-Range parseRange(std::string_view view) {
-  Range res{};
-  utils::Parser p{view};
-  res.first = p.getUnsignedInt();
-  p.drop(1);
-  res.second = p.getUnsignedInt();
-  return res;
-}
-
-class RangeSet {
-private:
-  // All ranges there will be disjoint
-  std::map<size_t, size_t> ranges;
-
-public:
-  void addRange(Range range) {
-    auto lBound = std::lower_bound(ranges.begin(), ranges.end(), range);
-    if (lBound != begin(ranges)) {
-      lBound--;
-      auto &prev = *lBound;
-      // Case where we can merge with previous element
-      if (prev.second >= range.first) {
-        if (prev.second >= range.second)
-          return;
-        prev.second = range.second;
-        lBound++;
-        // Check to see if we also overlap with next
-        if (lBound != ranges.end() && lBound->first <= prev.second) {
-          prev.second = lBound->second;
-          ranges.erase(lBound);
-        }
-        return;
-      }
-      lBound++;
-    }
-    if (lBound == ranges.end() || lBound->first > range.second) {
-      ranges.insert(range);
-      return;
-    }
-    // There is overlap with next one
-    if (lBound->first == range.first) // Range is already contained
-      return;
-
-    // Now there is only the case where we have new range
-    // having lower bound than lBound but start at least
-    // contained in lBound
-
-    if (range.second <= lBound->second) {
-      range.second = lBound->second;
-      ranges.erase(lBound);
-      ranges.insert(range);
-      return;
-    }
-
-    if (range.second > lBound->second) {
-      Range toDelete{*lBound};
-      lBound++;
-      if (range.second >= lBound->first) {
-        range.second = lBound->second;
-        ranges.erase(lBound);
-      }
-      ranges.erase(toDelete.first);
-      ranges.insert(range);
-    }
-  }
-
-  size_t getDisjointIntervals() const { return ranges.size(); }
-  bool isContained(size_t value) const {
-    auto lb = std::lower_bound(begin(ranges), end(ranges),
-                               std::make_pair(value, value));
-    if (lb == begin(ranges))
-      return false;
-    lb--;
-    return lb->second >= value;
-  }
-};
-
-size_t nbIngredients() {
+size_t nbIngredients(std::ranges::view auto &&rangeLines,
+                     std::ranges::view auto &&idLines) {
   RangeSet rs{};
-  for (auto range : getLines() | std::views::transform(parseRange))
+  for (auto range : rangeLines | std::views::transform(parseRange))
     rs.addRange(range);
-  return std::ranges::fold_left(
-      getLines() | std::views::transform([&rs](std::string_view v) -> size_t {
-        utils::Parser p{v};
-        auto val = p.getUnsignedInt();
-        return rs.isContained(val) ? 1 : 0;
-      }),
-      size_t{0}, std::plus<>{});
+  auto ids = std::ranges::to<std::vector>(
+      idLines | std::views::transform([](std::string_view v) -> uint64_t {
+        return utils::Parser{v}.getUnsigned<uint64_t>();
+      }));
+  return rs.countContained(ids);
 }
 
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view exampleRanges{"3-5\n10-14\n16-20\n12-18\n"};
+constexpr std::string_view exampleIds{"1\n5\n8\n11\n17\n32\n"};
+
+utils::bench::Registration const benchIngredients{
+    "day5/RangeSet",
+    [](size_t scale) {
+      return utils::bench::repeatLines(exampleRanges, scale) + '\n' +
+             utils::bench::repeatLines(exampleIds, scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      auto separator = input.find("\n\n");
+      return nbIngredients(utils::bench::getLines(input.substr(0, separator)),
+                           utils::bench::getLines(input.substr(separator + 2)));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
-  auto res = nbIngredients();
+  // Generators only start reading when iterated, ranges first
+  auto res = nbIngredients(getLines(), getLines());
   std::cout << "N ingredients: " << res << '\n';
   return 0;
 }
+#endif
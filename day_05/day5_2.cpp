@@ -1,4 +1,7 @@
-#include "utils/parser.hpp"
+#include "rangeset.hpp"
+#include "utils/bench.hpp"
+#include "utils/io.hpp"
+#include "utils/parallel.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -6,117 +9,50 @@
 #include <generator>
 #include <iostream>
 #include <iterator>
-#include <map>
 #include <ranges>
 #include <string>
 #include <string_view>
-#include <utility>
-
-using Range = std::pair<size_t, size_t>;
+#include <vector>
 
+// Lines up to the next blank one
 std::generator<std::string_view> getLines() {
-  std::string res{};
-  while (std::getline(std::cin, res)) {
-    if (res.empty())
+  for (auto line : utils::getLines()) {
+    if (line.empty())
       co_return;
-    co_yield res;
+    co_yield line;
   }
 }
 
-Range parseRange(std::string_view view) {
-  Range res{};
-  utils::Parser p{view};
-  res.first = p.getUnsignedInt();
-  p.drop(1);
-  res.second = p.getUnsignedInt();
-  return res;
-}
-
-class RangeSet {
-private:
-  // All ranges there will be disjoint
-  std::map<size_t, size_t> ranges;
-
-public:
-  void addRange(Range range) {
-    auto lBound = std::lower_bound(ranges.begin(), ranges.end(), range);
-    if (lBound != begin(ranges)) {
-      lBound--;
-      auto &prev = *lBound;
-      // Case where we can merge with previous element
-      if (prev.second >= range.first) {
-        if (prev.second >= range.second)
-          return;
-        prev.second = range.second;
-        lBound++;
-        // Check to see if we also overlap with next
-        if (lBound != ranges.end() && lBound->first <= prev.second) {
-          prev.second = lBound->second;
-          ranges.erase(lBound);
-        }
-        return;
-      }
-      lBound++;
-    }
-    if (lBound == ranges.end() || lBound->first > range.second) {
-      ranges.insert(range);
-      return;
-    }
-    // There is overlap with next one
-    if (lBound->first == range.first) // Range is already contained
-      return;
-
-    // Now there is only the case where we have new range
-    // having lower bound than lBound but start at least
-    // contained in lBound
-
-    if (range.second <= lBound->second) {
-      range.second = lBound->second;
-      ranges.erase(lBound);
-      ranges.insert(range);
-      return;
-    }
-
-    if (range.second > lBound->second) {
-      Range toDelete{*lBound};
-      lBound++;
-      if (range.second >= lBound->first) {
-        range.second = lBound->second;
-        ranges.erase(lBound);
-      }
-      ranges.erase(toDelete.first);
-      ranges.insert(range);
-    }
-  }
-
-  size_t getDisjointIntervals() const { return ranges.size(); }
-  bool isContained(size_t value) const {
-    auto lb = std::lower_bound(begin(ranges), end(ranges),
-                               std::make_pair(value, value));
-    if (lb == begin(ranges))
-      return false;
-    lb--;
-    return lb->second >= value;
-  }
-
-  uint64_t countValidValues() const {
-    return std::ranges::fold_left(
-        ranges | std::views::transform([](auto elem) -> uint64_t {
-          return elem.second - elem.first + 1;
-        }),
-        uint64_t{0}, std::plus<>{});
-  }
-};
-
-size_t nbIngredients() {
-  RangeSet rs{};
-  for (auto range : getLines() | std::views::transform(parseRange))
-    rs.addRange(range);
+size_t nbIngredients(std::ranges::view auto &&rangeLines) {
+  auto rs = RangeSet::fromRangesParallel(
+      std::ranges::to<std::vector>(rangeLines |
+                                   std::views::transform(parseRange)),
+      utils::getNbThreads());
   return rs.countValidValues();
 }
 
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view exampleRanges{"3-5\n10-14\n16-20\n12-18\n"};
+constexpr std::string_view exampleIds{"1\n5\n8\n11\n17\n32\n"};
+
+utils::bench::Registration const benchValidValues{
+    "day5_2/RangeSet",
+    [](size_t scale) {
+      return utils::bench::repeatLines(exampleRanges, scale) + '\n' +
+             utils::bench::repeatLines(exampleIds, scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      auto separator = input.find("\n\n");
+      return nbIngredients(utils::bench::getLines(input.substr(0, separator)));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
-  auto res = nbIngredients();
+  auto res = nbIngredients(getLines());
   std::cout << "N valid ingredient IDS: " << res << '\n';
   return 0;
 }
+#endif
@@ -0,0 +1,525 @@
+#ifndef DAY_05_RANGESET_HPP
+#define DAY_05_RANGESET_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utils/parallel.hpp"
+#include "utils/parser.hpp"
+#include "utils/random.hpp"
+#include "utils/sort.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Inclusive range of IDs
+using Range = std::pair<size_t, size_t>;
+
+constexpr Range parseRange(std::string_view view) {
+  Range res{};
+  utils::Parser p{view};
+  res.first = p.getUnsigned<size_t>();
+  p.drop(1);
+  res.second = p.getUnsigned<size_t>();
+  return res;
+}
+
+namespace detail {
+// Number of values of block that are at most bound, over blockSize values
+inline constexpr size_t blockSize{8};
+
+constexpr size_t countAtMostScalar(uint64_t const *block, uint64_t bound) {
+  size_t res{0};
+  for (size_t i{0}; i < blockSize; ++i)
+    res += block[i] <= bound;
+  return res;
+}
+
+#if defined(__AVX2__)
+inline size_t countAtMostSimd(uint64_t const *block, uint64_t bound) {
+  // AVX2 only compares signed 64-bit lanes: flip the sign bits first
+  auto flip = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+  auto limit = _mm256_xor_si256(
+      _mm256_set1_epi64x(static_cast<int64_t>(bound)), flip);
+  auto lo = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block)), flip);
+  auto hi = _mm256_xor_si256(
+      _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block + 4)), flip);
+  auto above = static_cast<unsigned>(
+      _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(lo, limit))) |
+      (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(hi, limit)))
+       << 4));
+  return blockSize - static_cast<size_t>(std::popcount(above));
+}
+#endif
+
+// First position at or after pos whose value exceeds bound, values being
+// sorted. Dense runs are crossed a block at a time.
+constexpr size_t skipAtMost(std::span<uint64_t const> values, size_t pos,
+                            uint64_t bound) {
+  while (pos + blockSize <= values.size()) {
+    size_t nbBelow{};
+#if defined(__AVX2__)
+    if !consteval {
+      nbBelow = countAtMostSimd(values.data() + pos, bound);
+    } else {
+      nbBelow = countAtMostScalar(values.data() + pos, bound);
+    }
+#else
+    nbBelow = countAtMostScalar(values.data() + pos, bound);
+#endif
+    pos += nbBelow;
+    if (nbBelow < blockSize)
+      return pos;
+  }
+  while (pos < values.size() && values[pos] <= bound)
+    pos += 1;
+  return pos;
+}
+} // namespace detail
+
+// Set of IDs as sorted disjoint ranges, stored as two flat arrays of starts
+// and ends. Added ranges are buffered and merged in by batches, so a series
+// of addRange costs O(n log n) overall instead of one shift per insertion.
+class RangeSet {
+public:
+  constexpr RangeSet() = default;
+
+  // Bulk load: one sort, then one merging pass
+  constexpr explicit RangeSet(std::vector<Range> ranges)
+      : pending(std::move(ranges)) {
+    mergePending();
+  }
+
+  constexpr void addRange(Range range) {
+    pending.push_back(range);
+    if (pending.size() >= std::max(minBatch, starts.size() / 4))
+      mergePending();
+  }
+
+  // Queries first fold the buffered ranges in, hence are not const
+
+  constexpr size_t getDisjointIntervals() {
+    mergePending();
+    return starts.size();
+  }
+
+  constexpr bool isContained(size_t value) {
+    mergePending();
+    if (starts.empty())
+      return false;
+    // Branchless search of the last range starting at or before value
+    size_t base{0};
+    for (auto size = starts.size(); size > 1; size -= size / 2) {
+      auto half = size / 2;
+      base = starts[base + half] <= value ? base + half : base;
+    }
+    return starts[base] <= value && value <= ends[base];
+  }
+
+  constexpr uint64_t countValidValues() {
+    mergePending();
+    uint64_t res{0};
+    for (size_t idx{0}; idx < starts.size(); ++idx)
+      res += ends[idx] - starts[idx] + 1;
+    return res;
+  }
+
+  // Number of values within the set, duplicates included. The values are
+  // sorted, then swept along with the ranges in a single pass.
+  constexpr size_t countContained(std::span<uint64_t const> values) {
+    mergePending();
+    std::vector<uint64_t> sorted(values.begin(), values.end());
+    utils::radixSort(std::span{sorted});
+    size_t res{0};
+    size_t pos{0};
+    for (size_t idx{0}; idx < starts.size() && pos < sorted.size(); ++idx) {
+      if (starts[idx] != 0)
+        pos = detail::skipAtMost(sorted, pos, starts[idx] - 1);
+      auto first = pos;
+      pos = detail::skipAtMost(sorted, pos, ends[idx]);
+      res += pos - first;
+    }
+    return res;
+  }
+
+  // Bulk load on up to nbThreads threads. The ranges are sorted in parallel,
+  // then a segmented scan over the running maximum of their ends finds the
+  // disjoint ranges: a range opens a new one when it starts after every
+  // previous end (plus one, touching ranges are joined).
+  static RangeSet fromRangesParallel(std::vector<Range> ranges,
+                                     size_t nbThreads) {
+    RangeSet res{};
+    if (ranges.empty())
+      return res;
+    utils::parallelSort(ranges, nbThreads,
+                        [](Range const &range) { return range.first; });
+    auto nbChunks = std::clamp(nbThreads, size_t{1}, ranges.size());
+    auto chunk = [&](size_t c) {
+      return std::span{ranges}.subspan(
+          c * ranges.size() / nbChunks,
+          (c + 1) * ranges.size() / nbChunks - c * ranges.size() / nbChunks);
+    };
+
+    // Running maximum of the ends before each chunk
+    std::vector<size_t> maxEndBefore(nbChunks);
+    {
+      std::vector<std::jthread> workers{};
+      for (size_t c{0}; c < nbChunks; ++c) {
+        workers.emplace_back([&, c] {
+          maxEndBefore[c] = std::ranges::max(chunk(c) | std::views::values);
+        });
+      }
+    }
+    std::exclusive_scan(maxEndBefore.begin(), maxEndBefore.end(),
+                        maxEndBefore.begin(), size_t{0},
+                        [](size_t a, size_t b) { return std::max(a, b); });
+
+    // Starts of the disjoint ranges opening in each chunk, and ends of those
+    // closing in it
+    std::vector<std::vector<size_t>> chunkStarts(nbChunks);
+    std::vector<std::vector<size_t>> chunkEnds(nbChunks);
+    {
+      std::vector<std::jthread> workers{};
+      for (size_t c{0}; c < nbChunks; ++c) {
+        workers.emplace_back([&, c] {
+          auto maxEnd = maxEndBefore[c];
+          auto opensFirst = c == 0;
+          for (auto [start, end] : chunk(c)) {
+            if (std::exchange(opensFirst, false)) {
+              chunkStarts[c].push_back(start);
+            } else if (start != 0 && start - 1 > maxEnd) {
+              chunkEnds[c].push_back(maxEnd);
+              chunkStarts[c].push_back(start);
+            }
+            maxEnd = std::max(maxEnd, end);
+          }
+        });
+      }
+    }
+    for (size_t c{0}; c < nbChunks; ++c) {
+      res.starts.insert(res.starts.end(), chunkStarts[c].begin(),
+                        chunkStarts[c].end());
+      res.ends.insert(res.ends.end(), chunkEnds[c].begin(),
+                      chunkEnds[c].end());
+    }
+    // The last disjoint range closes with the overall maximum end
+    res.ends.push_back(std::max(
+        maxEndBefore.back(),
+        std::ranges::max(chunk(nbChunks - 1) | std::views::values)));
+    return res;
+  }
+
+private:
+  static constexpr size_t minBatch{64};
+
+  // Sorts the buffered ranges and merges them with the stored ones, joining
+  // the ranges that overlap or touch
+  constexpr void mergePending() {
+    if (pending.empty())
+      return;
+    std::ranges::sort(pending);
+    std::vector<Range> merged{};
+    merged.reserve(starts.size() + pending.size());
+    auto stored = std::views::iota(size_t{0}, starts.size()) |
+                  std::views::transform([this](size_t idx) {
+                    return Range{starts[idx], ends[idx]};
+                  });
+    std::ranges::merge(stored, pending, std::back_inserter(merged));
+    pending.clear();
+    starts.clear();
+    ends.clear();
+    for (auto [start, end] : merged) {
+      if (!ends.empty() && (start == 0 || start - 1 <= ends.back())) {
+        ends.back() = std::max(ends.back(), end);
+        continue;
+      }
+      starts.push_back(start);
+      ends.push_back(end);
+    }
+  }
+
+  std::vector<size_t> starts{};
+  std::vector<size_t> ends{};
+  std::vector<Range> pending{};
+};
+
+// Set of IDs as disjoint ranges supporting removals, kept in a treap ordered
+// by range start. Nodes live in an arena vector and hold the number of IDs
+// covered by their subtree, so updates and range counts take O(log n)
+// expected time.
+class DynamicRangeSet {
+public:
+  constexpr DynamicRangeSet() = default;
+
+  // Inserts range, joining the ranges it overlaps or touches
+  constexpr void addRange(Range range) {
+    auto [start, end] = range;
+    auto [left, rest] = splitBefore(root, start);
+    auto [middle, right] = splitAfter(rest, end == maxId ? end : end + 1);
+    if (middle != nil) {
+      end = std::max(end, nodes[rightmost(middle)].end);
+      release(middle);
+    }
+    if (left != nil) {
+      auto last = rightmost(left);
+      if (nodes[last].end >= start - 1) {
+        start = nodes[last].start;
+        end = std::max(end, nodes[last].end);
+        left = splitBefore(left, start).first;
+        release(last);
+      }
+    }
+    root = merge(merge(left, newNode(start, end)), right);
+  }
+
+  // Removes every ID of range, splitting the ranges it partially covers
+  constexpr void removeRange(Range range) {
+    auto [start, end] = range;
+    auto [left, rest] = splitBefore(root, start);
+    auto [middle, right] = splitAfter(rest, end);
+    auto kept = nil;
+    if (middle != nil) {
+      auto lastEnd = nodes[rightmost(middle)].end;
+      if (lastEnd > end)
+        kept = newNode(end + 1, lastEnd);
+      release(middle);
+    }
+    if (left != nil) {
+      auto last = rightmost(left);
+      if (nodes[last].end >= start) {
+        if (nodes[last].end > end)
+          kept = newNode(end + 1, nodes[last].end);
+        left = splitBefore(left, nodes[last].start).first;
+        nodes[last].end = start - 1;
+        update(last);
+        left = merge(left, last);
+      }
+    }
+    root = merge(merge(left, kept), right);
+  }
+
+  constexpr size_t getDisjointIntervals() const {
+    return root == nil ? 0 : nodes[root].nbRanges;
+  }
+
+  constexpr bool isContained(size_t value) const {
+    auto node = floorNode(value);
+    return node != nil && value <= nodes[node].end;
+  }
+
+  constexpr uint64_t countValidValues() const {
+    return root == nil ? 0 : nodes[root].covered;
+  }
+
+  // Number of IDs of range within the set
+  constexpr uint64_t countCovered(Range range) const {
+    auto [start, end] = range;
+    return coveredUpTo(end) - (start == 0 ? 0 : coveredUpTo(start - 1));
+  }
+
+  // Smallest ID at or after value outside of the set, if any
+  constexpr std::optional<size_t> nextUncovered(size_t value) const {
+    auto node = floorNode(value);
+    if (node == nil || nodes[node].end < value)
+      return value;
+    // Touching ranges are joined, the one after the end is not covered
+    if (nodes[node].end == maxId)
+      return std::nullopt;
+    return nodes[node].end + 1;
+  }
+
+private:
+  static constexpr size_t nil{std::numeric_limits<size_t>::max()};
+  static constexpr size_t maxId{std::numeric_limits<size_t>::max()};
+
+  struct Node {
+    size_t start;
+    size_t end;
+    uint64_t priority;
+    size_t left{nil};
+    size_t right{nil};
+    // Number of IDs and of ranges in the subtree
+    uint64_t covered{0};
+    size_t nbRanges{0};
+  };
+
+  constexpr size_t newNode(size_t start, size_t end) {
+    Node node{.start = start, .end = end, .priority = random()};
+    size_t idx{};
+    if (freeNodes.empty()) {
+      idx = nodes.size();
+      nodes.push_back(node);
+    } else {
+      idx = freeNodes.back();
+      freeNodes.pop_back();
+      nodes[idx] = node;
+    }
+    update(idx);
+    return idx;
+  }
+
+  // Gives the nodes of the subtree back to the arena
+  constexpr void release(size_t tree) {
+    if (tree == nil)
+      return;
+    release(nodes[tree].left);
+    release(nodes[tree].right);
+    freeNodes.push_back(tree);
+  }
+
+  constexpr void update(size_t idx) {
+    auto &node = nodes[idx];
+    node.covered = node.end - node.start + 1;
+    node.nbRanges = 1;
+    for (auto child : {node.left, node.right}) {
+      if (child != nil) {
+        node.covered += nodes[child].covered;
+        node.nbRanges += nodes[child].nbRanges;
+      }
+    }
+  }
+
+  // Splits tree between the ranges starting at or before key and the others
+  constexpr std::pair<size_t, size_t> splitAfter(size_t tree, size_t key) {
+    if (tree == nil)
+      return {nil, nil};
+    if (nodes[tree].start <= key) {
+      auto [left, right] = splitAfter(nodes[tree].right, key);
+      nodes[tree].right = left;
+      update(tree);
+      return {tree, right};
+    }
+    auto [left, right] = splitAfter(nodes[tree].left, key);
+    nodes[tree].left = right;
+    update(tree);
+    return {left, tree};
+  }
+
+  // Splits tree between the ranges starting before key and the others
+  constexpr std::pair<size_t, size_t> splitBefore(size_t tree, size_t key) {
+    if (key == 0)
+      return {nil, tree};
+    return splitAfter(tree, key - 1);
+  }
+
+  // Joins two trees, the ranges of left all being before those of right
+  constexpr size_t merge(size_t left, size_t right) {
+    if (left == nil)
+      return right;
+    if (right == nil)
+      return left;
+    if (nodes[left].priority > nodes[right].priority) {
+      nodes[left].right = merge(nodes[left].right, right);
+      update(left);
+      return left;
+    }
+    nodes[right].left = merge(left, nodes[right].left);
+    update(right);
+    return right;
+  }
+
+  constexpr size_t rightmost(size_t tree) const {
+    while (nodes[tree].right != nil)
+      tree = nodes[tree].right;
+    return tree;
+  }
+
+  // Last range starting at or before value
+  constexpr size_t floorNode(size_t value) const {
+    auto res = nil;
+    for (auto node = root; node != nil;) {
+      if (nodes[node].start <= value) {
+        res = node;
+        node = nodes[node].right;
+      } else {
+        node = nodes[node].left;
+      }
+    }
+    return res;
+  }
+
+  // Number of IDs of the set which are at most value
+  constexpr uint64_t coveredUpTo(size_t value) const {
+    uint64_t res{0};
+    for (auto node = root; node != nil;) {
+      auto const &current = nodes[node];
+      if (current.start > value) {
+        node = current.left;
+        continue;
+      }
+      if (current.left != nil)
+        res += nodes[current.left].covered;
+      res += std::min(current.end, value) - current.start + 1;
+      node = current.right;
+    }
+    return res;
+  }
+
+  std::vector<Node> nodes{};
+  std::vector<size_t> freeNodes{};
+  size_t root{nil};
+  utils::Random random{0x5EED};
+};
+
+namespace detail {
+constexpr std::string_view exampleRanges{"3-5\n10-14\n16-20\n12-18"};
+
+constexpr RangeSet buildExample() {
+  RangeSet res{};
+  for (auto line : exampleRanges | std::views::split('\n'))
+    res.addRange(parseRange(std::string_view{line}));
+  return res;
+}
+
+constexpr bool checkExample() {
+  auto rs = buildExample();
+  auto nbFresh = std::ranges::count_if(
+      std::array<size_t, 6>{1, 5, 8, 11, 17, 32},
+      [&rs](size_t id) { return rs.isContained(id); });
+  std::array<uint64_t, 6> ids{32, 17, 11, 8, 5, 1};
+  return nbFresh == 3 && rs.countContained(ids) == 3 &&
+         rs.countValidValues() == 14 && rs.getDisjointIntervals() == 2;
+}
+static_assert(checkExample());
+
+constexpr bool checkJoinsTouching() {
+  RangeSet rs{{{1, 2}, {3, 4}, {0, 0}, {6, 6}}};
+  return rs.getDisjointIntervals() == 2 && rs.countValidValues() == 6;
+}
+static_assert(checkJoinsTouching());
+
+constexpr bool checkDynamic() {
+  DynamicRangeSet rs{};
+  for (auto line : exampleRanges | std::views::split('\n'))
+    rs.addRange(parseRange(std::string_view{line}));
+  if (rs.getDisjointIntervals() != 2 || rs.countValidValues() != 14 ||
+      rs.countCovered({4, 11}) != 4 || rs.nextUncovered(10) != 21 ||
+      rs.nextUncovered(7) != 7)
+    return false;
+  rs.removeRange({12, 13});
+  rs.removeRange({0, 3});
+  rs.addRange({6, 9});
+  // Left {4, 11} and {14, 20}
+  return rs.getDisjointIntervals() == 2 && rs.countValidValues() == 15 &&
+         !rs.isContained(13) && rs.isContained(14) && rs.isContained(4) &&
+         rs.countCovered({11, 14}) == 2 && rs.nextUncovered(4) == 12;
+}
+static_assert(checkDynamic());
+} // namespace detail
+
+#endif // DAY_05_RANGESET_HPP
@@ -1,5 +1,9 @@
+#include "worksheet.hpp"
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
 #include "utils/parser.hpp"
+#include "utils/random.hpp"
+#include "utils/scan.hpp"
 #include <algorithm>
 #include <cassert>
 #include <functional>
@@ -19,7 +23,7 @@ constexpr void getEntries(std::span<const char> line,
     p.eat(' ');
     if (p.empty())
       return;
-    res.push_back(p.getUnsignedInt());
+    res.push_back(p.getUnsigned<size_t>());
   }
 }
 
@@ -77,9 +81,87 @@ constexpr std::string_view example{"123 328  51 64 \n"
                                    "  6 98  215 314\n"
                                    "*   +   *   + "};
 
-static_assert(getResult(example | std::views::split('\n')) == 4277556);
+static_assert(parseWorksheet(example).sumRowWise() ==
+              getResult(utils::splitLines(example)));
+static_assert(getResult(utils::splitLines(example)) == 4277556);
 
-int main() {
-  auto res = getResult(utils::getLines());
+#ifdef AOC_BENCH
+namespace {
+utils::bench::Registration const benchResult{
+    "day6/getResult",
+    [](size_t scale) {
+      // Operator line padded to the width of the others, so that the
+      // copies stay aligned
+      std::string padded{example};
+      padded += ' ';
+      return utils::bench::repeatColumns(padded, scale, " ");
+    },
+    [](std::string_view input) -> uint64_t {
+      return getResult(utils::bench::getLines(input));
+    }};
+
+utils::bench::Registration const benchWorksheet{
+    "day6/Worksheet",
+    [](size_t scale) {
+      std::string padded{example};
+      padded += ' ';
+      return utils::bench::repeatColumns(padded, scale, " ");
+    },
+    [](std::string_view input) -> uint64_t {
+      return parseWorksheet(input).sumRowWise().getLowBits();
+    }};
+
+// The static_asserts only reach the scalar kernels, the SIMD ones are checked
+// here on random sheets of any height and width, so that the last group of
+// rows or columns is a partial one
+utils::bench::CheckRegistration const checkKernels{
+    "day6/Worksheet kernels", [] {
+      utils::Random random{6};
+      std::vector<uint64_t> simd{};
+      std::vector<uint64_t> scalar{};
+      for (size_t i{0}; i < 500; ++i) {
+        auto height = random.between(1, 30);
+        auto width = random.between(1, 40);
+        std::vector<std::string> rows(height + 1, std::string(width, ' '));
+        for (auto &row : rows | std::views::take(height)) {
+          for (auto &cell : row)
+            cell = random.chance(1, 4) ? ' '
+                                       : static_cast<char>(
+                                             '0' + random.between(1, 9));
+        }
+        for (auto &cell : rows.back())
+          cell = random.chance(1, 2) ? '*' : '+';
+        std::vector<std::string_view> lines(rows.begin(), rows.end());
+        Worksheet sheet{lines};
+        if (sheet.getColumnNumbers() != sheet.getColumnNumbersScalar())
+          return false;
+        for (auto const &problem : sheet.getProblems()) {
+          sheet.getRowNumbers(problem, simd);
+          sheet.getRowNumbersScalar(problem, scalar);
+          if (simd != scalar)
+            return false;
+        }
+      }
+      return true;
+    }};
+
+// Operands down columns thousands of digits tall
+utils::bench::CheckRegistration const checkLongColumns{
+    "day6/WideNumber", [] {
+      return detail::checkLongColumn(3990) && detail::checkLongColumn(4000) &&
+             detail::checkLongColumn(50'000);
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional argument: arithmetic of the results, checked (64 bits), wide
+// (128 bits) or exact (the default)
+int main(int argc, char **argv) {
+  auto arithmetic = argc > 1 ? parseArithmetic(argv[1]) : Arithmetic::Exact;
+  auto res = parseWorksheet(utils::MappedInput::standardInput().readAll())
+                 .sumRowWise(arithmetic)
+                 .toDecimal();
   std::cout << "Control sum: " << res << '\n';
 }
+#endif
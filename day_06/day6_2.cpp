@@ -1,9 +1,14 @@
+#include "worksheet.hpp"
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
+#include "utils/scan.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <functional>
 #include <iostream>
 #include <ranges>
+#include <span>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -55,14 +60,151 @@ constexpr size_t getResult(std::ranges::view auto &&lines) {
   return std::ranges::fold_left(subResults, size_t{0}, std::plus<>{});
 }
 
+// Single pass over the digit rows: every row is folded into one number per
+// column as it arrives, and the rows themselves are not kept. The numbers
+// still grow with the height, 8 bytes per 19 digits, as exact results need
+// all the digits of numbers running down the columns: memory is proportional
+// to the digits of the sheet, not to its width.
+class ColumnStream {
+public:
+  constexpr void addRow(std::string_view row) {
+    if (row.size() > numbers.size())
+      numbers.resize(row.size());
+    for (size_t column{0}; column < row.size(); ++column) {
+      if (row[column] != ' ')
+        numbers[column].addDigit(row[column]);
+    }
+  }
+
+  // Problems start at their operator
+  constexpr utils::BigUnsigned finish(std::string_view operators,
+                                      Arithmetic arithmetic) const {
+    ControlSum res{arithmetic};
+    for (size_t column{0}; column < operators.size(); ++column) {
+      auto op = operators[column];
+      if (op == ' ')
+        continue;
+      auto firstColumn = std::min(column, numbers.size());
+      auto endColumn = std::min(operators.find_first_not_of(' ', column + 1),
+                                numbers.size());
+      // Without the blank columns before the next problem
+      while (endColumn > firstColumn && numbers[endColumn - 1].empty())
+        --endColumn;
+      res.addProblem(op, std::span{numbers}.subspan(firstColumn,
+                                                    endColumn - firstColumn));
+    }
+    return res.get();
+  }
+
+private:
+  std::vector<detail::WideNumber> numbers{};
+};
+
+// Lines are read once from the top, up to the operator row. Nothing else of
+// the input is kept, which is streamed from a pipe as well as from a file.
+constexpr utils::BigUnsigned
+sumColumnsStreaming(std::ranges::input_range auto &&lines,
+                    Arithmetic arithmetic) {
+  ColumnStream stream{};
+  for (std::string_view line : lines) {
+    auto first = line.find_first_not_of(' ');
+    if (first == std::string_view::npos)
+      continue;
+    // The first problem may start after blank columns
+    if (line[first] == '*' || line[first] == '+')
+      return stream.finish(line, arithmetic);
+    stream.addRow(line);
+  }
+  return {};
+}
+
 constexpr std::string_view example{"123 328  51 64 \n"
                                    " 45 64  387 23 \n"
                                    "  6 98  215 314\n"
                                    "*   +   *   + "};
 
-static_assert(getResult(example | std::views::split('\n')) == 3263827);
+static_assert(sumColumnsStreaming(utils::splitLines(example),
+                                  Arithmetic::Exact) == 3263827);
+static_assert(sumColumnsStreaming(utils::splitLines(std::string{example} +
+                                                    "\n\n"),
+                                  Arithmetic::Checked) == 3263827);
+
+namespace detail {
+// Columns of 30 digits, past 64 bits: (10^30 - 1) * 2 + 111...1 * 222...2
+constexpr bool checkTallStream() {
+  std::string sheet{};
+  for (size_t i{0}; i < 30; ++i)
+    sheet += "99 12\n";
+  sheet += "+  * ";
+  utils::BigUnsigned repunit{};
+  for (size_t i{0}; i < 30; ++i)
+    repunit = repunit * utils::BigUnsigned{10} + utils::BigUnsigned{1};
+  auto nines = repunit * utils::BigUnsigned{9};
+  auto expected = nines + nines + repunit * repunit * utils::BigUnsigned{2};
+  return sumColumnsStreaming(utils::splitLines(sheet), Arithmetic::Exact) ==
+             expected &&
+         parseWorksheet(sheet).sumColumnWise() == expected;
+}
+static_assert(checkTallStream());
+} // namespace detail
+static_assert(parseWorksheet(example).sumColumnWise() ==
+              getResult(utils::splitLines(example)));
+static_assert(getResult(utils::splitLines(example)) == 3263827);
+
+#ifdef AOC_BENCH
+namespace {
+utils::bench::Registration const benchResult{
+    "day6_2/getResult",
+    [](size_t scale) {
+      // Operator line padded to the width of the others, so that the
+      // copies stay aligned
+      std::string padded{example};
+      padded += ' ';
+      return utils::bench::repeatColumns(padded, scale, " ");
+    },
+    [](std::string_view input) -> uint64_t {
+      return getResult(utils::bench::getLines(input));
+    }};
+
+utils::bench::Registration const benchWorksheet{
+    "day6_2/Worksheet",
+    [](size_t scale) {
+      std::string padded{example};
+      padded += ' ';
+      return utils::bench::repeatColumns(padded, scale, " ");
+    },
+    [](std::string_view input) -> uint64_t {
+      return parseWorksheet(input).sumColumnWise().getLowBits();
+    }};
+
+utils::bench::Registration const benchStreaming{
+    "day6_2/ColumnStream",
+    [](size_t scale) {
+      std::string padded{example};
+      padded += ' ';
+      return utils::bench::repeatColumns(padded, scale, " ");
+    },
+    [](std::string_view input) -> uint64_t {
+      return sumColumnsStreaming(utils::bench::getLines(input),
+                                 Arithmetic::Exact)
+          .getLowBits();
+    }};
+} // namespace
 
-int main() {
-  auto res = getResult(utils::getLines());
-  std::cout << "Got result: " << res << '\n';
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional arguments: arithmetic of the results, checked (64 bits), wide
+// (128 bits) or exact (the default), then engine, columnar (the default) or
+// stream for sheets too large to be transposed in memory. The stream reads
+// stdin line by line, only the numbers of the columns are kept.
+int main(int argc, char **argv) {
+  auto arithmetic = argc > 1 ? parseArithmetic(argv[1]) : Arithmetic::Exact;
+  auto streaming = argc > 2 && std::string_view{argv[2]} == "stream";
+  auto res =
+      streaming
+          ? sumColumnsStreaming(utils::getLines(), arithmetic)
+          : parseWorksheet(utils::MappedInput::standardInput().readAll())
+                .sumColumnWise(arithmetic);
+  std::cout << "Got result: " << res.toDecimal() << '\n';
 }
+#endif
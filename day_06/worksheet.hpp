@@ -0,0 +1,553 @@
+#ifndef DAY_06_WORKSHEET_HPP
+#define DAY_06_WORKSHEET_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+#include "utils/bigint.hpp"
+#include "utils/repdigits.hpp"
+#include "utils/scan.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+// Numbers of up to 19 digits fit in 64 bits, longer ones may not
+inline constexpr size_t maxNarrowDigits{19};
+
+// Appends the digit in cell to value, blank cells are skipped. Past 19
+// digits, value wraps modulo 2^64.
+constexpr void accumulateCell(uint64_t &value, char cell) {
+  if (cell != ' ')
+    value = value * 10 + static_cast<uint64_t>(cell - '0');
+}
+
+#if defined(__AVX2__)
+// Same on four lanes, cells being zero-extended to 64 bits
+inline __m256i accumulateCells(__m256i values, __m256i cells) {
+  auto isDigit = _mm256_cmpgt_epi64(cells, _mm256_set1_epi64x(' '));
+  auto times10 = _mm256_add_epi64(_mm256_slli_epi64(values, 3),
+                                  _mm256_slli_epi64(values, 1));
+  auto next = _mm256_add_epi64(
+      times10, _mm256_sub_epi64(cells, _mm256_set1_epi64x('0')));
+  return _mm256_blendv_epi8(values, next, isDigit);
+}
+#endif
+
+// Decimal number of any length, read one digit at a time: digits gather in
+// 64-bit chunks of 19, converted to a big integer only once all are read
+class WideNumber {
+public:
+  constexpr void addDigit(char digit) {
+    if (nbChunkDigits == maxNarrowDigits) {
+      chunks.push_back(chunk);
+      chunk = 0;
+      nbChunkDigits = 0;
+    }
+    chunk = chunk * 10 + static_cast<uint64_t>(digit - '0');
+    nbChunkDigits += 1;
+  }
+
+  constexpr bool empty() const { return chunks.empty() && nbChunkDigits == 0; }
+
+  // At most 19 digits, getNarrow() is the value
+  constexpr bool isNarrow() const { return chunks.empty(); }
+  constexpr uint64_t getNarrow() const { return chunk; }
+
+  constexpr utils::BigUnsigned get() const {
+    if (chunks.empty())
+      return utils::BigUnsigned{chunk};
+    // powers[k] = 10^(19 * 2^k), up to the largest split of the chunks
+    std::vector<utils::BigUnsigned> powers{
+        utils::BigUnsigned{Digits::powers[maxNarrowDigits]}};
+    while ((size_t{1} << powers.size()) < chunks.size())
+      powers.push_back(powers.back() * powers.back());
+    return fromChunks(chunks, powers) *
+               utils::BigUnsigned{Digits::powers[nbChunkDigits]} +
+           utils::BigUnsigned{chunk};
+  }
+
+private:
+  using Digits = utils::RepDigits<uint64_t>;
+
+  // Value of chunks, first one most significant, as a balanced tree: with
+  // 2^k < size <= 2^(k+1), high * 10^(19 * 2^k) + low where low is the last
+  // 2^k chunks, so that the large multiplications go to Karatsuba
+  static constexpr utils::BigUnsigned
+  fromChunks(std::span<uint64_t const> chunks,
+             std::span<utils::BigUnsigned const> powers) {
+    if (chunks.size() == 1)
+      return utils::BigUnsigned{chunks[0]};
+    auto level = static_cast<size_t>(std::bit_width(chunks.size() - 1)) - 1;
+    auto split = chunks.size() - (size_t{1} << level);
+    return fromChunks(chunks.first(split), powers) * powers[level] +
+           fromChunks(chunks.subspan(split), powers);
+  }
+
+  // Full chunks of 19 digits before the current one, first read first
+  std::vector<uint64_t> chunks{};
+  uint64_t chunk{0};
+  size_t nbChunkDigits{0};
+};
+} // namespace detail
+
+// Arithmetic of the problem results and of their sum
+enum class Arithmetic {
+  // 64 bits, std::overflow_error past that
+  Checked,
+  // 128 bits, std::overflow_error past that
+  Wide,
+  // 64 bits while values fit, then 128 bits, then arbitrary precision
+  Exact,
+};
+
+// Arithmetic named on the command line
+constexpr Arithmetic parseArithmetic(std::string_view name) {
+  if (name == "checked")
+    return Arithmetic::Checked;
+  if (name == "wide")
+    return Arithmetic::Wide;
+  if (name == "exact")
+    return Arithmetic::Exact;
+  throw std::invalid_argument{"Arithmetic is checked, wide or exact"};
+}
+
+// Sum of the problem results. Products are computed in the narrowest
+// arithmetic they fit in, checked multiplication detecting when to widen;
+// the rare ones beyond 128 bits finish as a product tree of big integers.
+class ControlSum {
+public:
+  constexpr explicit ControlSum(Arithmetic arithmetic)
+      : arithmetic(arithmetic) {}
+
+  constexpr void addProblem(char op, std::span<uint64_t const> numbers) {
+    switch (op) {
+    case '*':
+      addProduct(numbers);
+      break;
+    case '+':
+      // Sums of less than 2^64 values fit in 128 bits
+      add(std::ranges::fold_left(numbers, utils::uint128{0}, std::plus<>{}));
+      break;
+    default:
+      break;
+    }
+  }
+
+  // Same for operands of any length, only those past 19 digits are handled
+  // as big integers
+  constexpr void addProblem(char op,
+                            std::span<detail::WideNumber const> numbers) {
+    if (std::ranges::all_of(numbers, &detail::WideNumber::isNarrow)) {
+      narrowNumbers.clear();
+      for (auto const &number : numbers)
+        narrowNumbers.push_back(number.getNarrow());
+      return addProblem(op, narrowNumbers);
+    }
+    utils::BigUnsigned result{op == '*' ? 1u : 0u};
+    switch (op) {
+    case '*':
+      for (auto const &number : numbers)
+        result = result * number.get();
+      break;
+    case '+':
+      for (auto const &number : numbers)
+        result += number.get();
+      break;
+    default:
+      return;
+    }
+    addExact(result);
+  }
+
+  constexpr utils::BigUnsigned get() const {
+    return spill + utils::BigUnsigned{total};
+  }
+
+private:
+  static constexpr utils::uint128 max64{~uint64_t{0}};
+
+  constexpr void add(utils::uint128 value) {
+    if (arithmetic == Arithmetic::Checked && value > max64)
+      throw std::overflow_error{"Problem result exceeds 64 bits"};
+    utils::uint128 next;
+    if (__builtin_add_overflow(total, value, &next)) {
+      if (arithmetic != Arithmetic::Exact)
+        throw std::overflow_error{"Control sum exceeds 128 bits"};
+      spill += utils::BigUnsigned{total} + utils::BigUnsigned{value};
+      total = 0;
+      return;
+    }
+    if (arithmetic == Arithmetic::Checked && next > max64)
+      throw std::overflow_error{"Control sum exceeds 64 bits"};
+    total = next;
+  }
+
+  constexpr void addExact(utils::BigUnsigned const &value) {
+    auto bitWidth = value.getBitWidth();
+    if (arithmetic == Arithmetic::Checked && bitWidth > 64)
+      throw std::overflow_error{"Problem result exceeds 64 bits"};
+    if (bitWidth <= 128)
+      return add(value.getLowBits128());
+    if (arithmetic == Arithmetic::Wide)
+      throw std::overflow_error{"Problem result exceeds 128 bits"};
+    spill += value;
+  }
+
+  constexpr void addProduct(std::span<uint64_t const> numbers) {
+    uint64_t narrow{1};
+    size_t idx{0};
+    for (uint64_t next; idx < numbers.size(); ++idx, narrow = next) {
+      if (__builtin_mul_overflow(narrow, numbers[idx], &next))
+        break;
+    }
+    if (idx == numbers.size())
+      return add(narrow);
+    if (arithmetic == Arithmetic::Checked)
+      throw std::overflow_error{"Problem result exceeds 64 bits"};
+    utils::uint128 wide{narrow};
+    for (utils::uint128 next; idx < numbers.size(); ++idx, wide = next) {
+      if (__builtin_mul_overflow(wide, utils::uint128{numbers[idx]}, &next))
+        break;
+    }
+    if (idx == numbers.size())
+      return add(wide);
+    if (arithmetic == Arithmetic::Wide)
+      throw std::overflow_error{"Problem result exceeds 128 bits"};
+    spill += utils::BigUnsigned{wide} *
+             utils::BigUnsigned::product(numbers.subspan(idx));
+  }
+
+  Arithmetic arithmetic;
+  utils::uint128 total{0};
+  utils::BigUnsigned spill{};
+  // Buffer of the operands of wide problems that turn out narrow
+  std::vector<uint64_t> narrowNumbers{};
+};
+
+// Worksheet transposed in one pass into column-major storage: the cells of
+// a column are contiguous, top row first, and padded with blanks up to a
+// multiple of 8 rows. Problems are the runs of columns between blank ones,
+// with their operator on the last line.
+//
+// Numbers are read four at a time in 64-bit lanes: along the rows (part 1),
+// four rows of a column are one 32-bit load; down the columns (part 2), a
+// lane holds a word of 8 cells of its column.
+class Worksheet {
+public:
+  struct Problem {
+    size_t firstColumn;
+    size_t endColumn;
+    char op;
+  };
+
+  // Digit rows followed by the operator row
+  constexpr explicit Worksheet(std::span<std::string_view const> lines) {
+    if (lines.empty())
+      return;
+    height = lines.size() - 1;
+    stride = std::max(size_t{8}, (height + 7) / 8 * 8);
+    width = std::ranges::max(lines | std::views::transform(
+                                         &std::string_view::size));
+    // Room for the last group of four columns
+    cells.assign((width + 3) / 4 * 4 * stride, ' ');
+    for (size_t row{0}; row < height; ++row) {
+      auto line = lines[row];
+      for (size_t column{0}; column < line.size(); ++column)
+        cells[column * stride + row] = line[column];
+    }
+
+    auto operators = lines.back();
+    for (size_t column{0}; column < width; ++column) {
+      if (isBlank(column))
+        continue;
+      Problem problem{column, column, ' '};
+      for (; problem.endColumn < width && !isBlank(problem.endColumn);
+           ++problem.endColumn) {
+        if (problem.endColumn < operators.size() &&
+            operators[problem.endColumn] != ' ')
+          problem.op = operators[problem.endColumn];
+      }
+      problems.push_back(problem);
+      column = problem.endColumn;
+    }
+  }
+
+  constexpr size_t getHeight() const { return height; }
+  constexpr size_t getWidth() const { return width; }
+  constexpr std::span<Problem const> getProblems() const { return problems; }
+
+  // Numbers of problem read along its rows, top to bottom. As in the puzzle,
+  // every row holds one number of each problem.
+  constexpr void getRowNumbers(Problem const &problem,
+                               std::vector<uint64_t> &numbers) const {
+#if defined(__AVX2__)
+    if !consteval {
+      numbers.assign(stride, 0);
+      getRowNumbersSimd(problem, numbers.data());
+      numbers.resize(height);
+      return;
+    }
+#endif
+    getRowNumbersScalar(problem, numbers);
+  }
+
+  // Same one cell at a time, the reference of the SIMD kernel
+  constexpr void getRowNumbersScalar(Problem const &problem,
+                                     std::vector<uint64_t> &numbers) const {
+    numbers.assign(height, 0);
+    for (auto column = problem.firstColumn; column < problem.endColumn;
+         ++column) {
+      for (size_t row{0}; row < height; ++row)
+        detail::accumulateCell(numbers[row], cells[column * stride + row]);
+    }
+  }
+
+  // Number read down each column of the sheet, 0 for the blank ones, modulo
+  // 2^64 for the columns of more than 19 digits
+  constexpr std::vector<uint64_t> getColumnNumbers() const {
+#if defined(__AVX2__)
+    if !consteval {
+      std::vector<uint64_t> numbers((width + 3) / 4 * 4, 0);
+      getColumnNumbersSimd(numbers.data());
+      numbers.resize(width);
+      return numbers;
+    }
+#endif
+    return getColumnNumbersScalar();
+  }
+
+  // Same one cell at a time, the reference of the SIMD kernel
+  constexpr std::vector<uint64_t> getColumnNumbersScalar() const {
+    std::vector<uint64_t> numbers(width, 0);
+    for (size_t column{0}; column < width; ++column) {
+      for (size_t row{0}; row < height; ++row)
+        detail::accumulateCell(numbers[column], cells[column * stride + row]);
+    }
+    return numbers;
+  }
+
+  // Numbers of problem along its rows, of any length
+  constexpr void
+  getWideRowNumbers(Problem const &problem,
+                    std::vector<detail::WideNumber> &numbers) const {
+    numbers.assign(height, {});
+    for (auto column = problem.firstColumn; column < problem.endColumn;
+         ++column) {
+      for (size_t row{0}; row < height; ++row) {
+        if (auto cell = cells[column * stride + row]; cell != ' ')
+          numbers[row].addDigit(cell);
+      }
+    }
+  }
+
+  // Number down column, of any length
+  constexpr detail::WideNumber getWideColumnNumber(size_t column) const {
+    detail::WideNumber res{};
+    for (auto cell : std::span{cells}.subspan(column * stride, height)) {
+      if (cell != ' ')
+        res.addDigit(cell);
+    }
+    return res;
+  }
+
+  // Sum of the results of the problems, numbers read along the rows. Those
+  // of problems wider than 19 columns may not fit in 64 bits.
+  constexpr utils::BigUnsigned
+  sumRowWise(Arithmetic arithmetic = Arithmetic::Exact) const {
+    ControlSum res{arithmetic};
+    std::vector<uint64_t> numbers{};
+    std::vector<detail::WideNumber> wideNumbers{};
+    for (auto const &problem : problems) {
+      if (problem.endColumn - problem.firstColumn <= detail::maxNarrowDigits) {
+        getRowNumbers(problem, numbers);
+        res.addProblem(problem.op, numbers);
+      } else {
+        getWideRowNumbers(problem, wideNumbers);
+        res.addProblem(problem.op, wideNumbers);
+      }
+    }
+    return res.get();
+  }
+
+  // Sum of the results of the problems, numbers read down the columns. On
+  // sheets taller than 19 rows, those of more than 19 digits are read again
+  // as big integers.
+  constexpr utils::BigUnsigned
+  sumColumnWise(Arithmetic arithmetic = Arithmetic::Exact) const {
+    ControlSum res{arithmetic};
+    auto numbers = getColumnNumbers();
+    std::vector<detail::WideNumber> wideNumbers{};
+    for (auto const &problem : problems) {
+      auto columns = std::views::iota(problem.firstColumn, problem.endColumn);
+      if (height > detail::maxNarrowDigits &&
+          std::ranges::any_of(columns, [this](size_t column) {
+            return countDigits(column) > detail::maxNarrowDigits;
+          })) {
+        wideNumbers.clear();
+        for (auto column : columns)
+          wideNumbers.push_back(getWideColumnNumber(column));
+        res.addProblem(problem.op, wideNumbers);
+        continue;
+      }
+      res.addProblem(problem.op,
+                     std::span{numbers}.subspan(problem.firstColumn,
+                                                problem.endColumn -
+                                                    problem.firstColumn));
+    }
+    return res.get();
+  }
+
+private:
+  constexpr size_t countDigits(size_t column) const {
+    return static_cast<size_t>(std::ranges::count_if(
+        std::span{cells}.subspan(column * stride, height),
+        [](char cell) { return cell != ' '; }));
+  }
+
+  constexpr bool isBlank(size_t column) const {
+    return std::ranges::all_of(
+        std::span{cells}.subspan(column * stride, height),
+        [](char cell) { return cell == ' '; });
+  }
+
+#if defined(__AVX2__)
+  // Four rows at a time, numbers holding stride values
+  void getRowNumbersSimd(Problem const &problem, uint64_t *numbers) const {
+    for (size_t row{0}; row < height; row += 4) {
+      auto values = _mm256_setzero_si256();
+      for (auto column = problem.firstColumn; column < problem.endColumn;
+           ++column) {
+        int32_t quad;
+        std::memcpy(&quad, cells.data() + column * stride + row, sizeof(quad));
+        values = detail::accumulateCells(
+            values, _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(quad)));
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(numbers + row), values);
+    }
+  }
+
+  // Four columns at a time, numbers holding the padded width
+  void getColumnNumbersSimd(uint64_t *numbers) const {
+    auto lowByte = _mm256_set1_epi64x(0xFF);
+    for (size_t column{0}; column < width; column += 4) {
+      auto values = _mm256_setzero_si256();
+      for (size_t word{0}; word < height; word += 8) {
+        auto load = [&](size_t offset) {
+          int64_t res;
+          std::memcpy(&res, cells.data() + (column + offset) * stride + word,
+                      sizeof(res));
+          return res;
+        };
+        // Little-endian: the top cell of the word is the low byte
+        auto words = _mm256_set_epi64x(load(3), load(2), load(1), load(0));
+        for (auto row = word; row < std::min(word + 8, height); ++row) {
+          values = detail::accumulateCells(values,
+                                           _mm256_and_si256(words, lowByte));
+          words = _mm256_srli_epi64(words, 8);
+        }
+      }
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(numbers + column),
+                          values);
+    }
+  }
+#endif
+
+  size_t height{0};
+  size_t width{0};
+  // Rows per column in storage, a multiple of 8
+  size_t stride{8};
+  std::vector<char> cells{};
+  std::vector<Problem> problems{};
+};
+
+// Worksheet of a whole input, the lines after the operator row ignored
+constexpr Worksheet parseWorksheet(std::string_view input) {
+  std::vector<std::string_view> lines{};
+  for (auto line : utils::splitLines(input)) {
+    if (line.empty())
+      continue;
+    lines.push_back(line);
+    if (line[0] == '*' || line[0] == '+')
+      break;
+  }
+  return Worksheet{lines};
+}
+
+namespace detail {
+constexpr std::string_view exampleSheet{"123 328  51 64 \n"
+                                        " 45 64  387 23 \n"
+                                        "  6 98  215 314\n"
+                                        "*   +   *   + "};
+
+constexpr bool checkExample() {
+  auto sheet = parseWorksheet(exampleSheet);
+  auto columns = sheet.getColumnNumbers();
+  return sheet.getProblems().size() == 4 && sheet.getHeight() == 3 &&
+         columns[0] == 1 && columns[2] == 356 && columns[3] == 0 &&
+         sheet.sumRowWise() == 4277556 && sheet.sumColumnWise() == 3263827 &&
+         sheet.sumRowWise(Arithmetic::Checked) == 4277556 &&
+         sheet.sumColumnWise(Arithmetic::Wide) == 3263827;
+}
+static_assert(checkExample());
+
+// Products of 30 numbers of 5 digits, past 128 bits. Down the columns, the
+// numbers are the 30-digit repdigits, past 64 bits.
+constexpr bool checkTallProducts() {
+  std::vector<std::string_view> lines(30, "99999 12345");
+  lines.push_back("*     *    ");
+  Worksheet sheet{lines};
+  auto expected =
+      utils::BigUnsigned::product(std::vector<uint64_t>(30, 99999)) +
+      utils::BigUnsigned::product(std::vector<uint64_t>(30, 12345));
+  utils::BigUnsigned repunit{};
+  for (size_t i{0}; i < 30; ++i)
+    repunit = repunit * utils::BigUnsigned{10} + utils::BigUnsigned{1};
+  auto nines = repunit * utils::BigUnsigned{9};
+  auto expectedColumns = nines * nines * nines * nines * nines;
+  utils::BigUnsigned digitProduct{1};
+  for (unsigned digit{1}; digit <= 5; ++digit)
+    digitProduct = digitProduct * repunit * utils::BigUnsigned{digit};
+  expectedColumns += digitProduct;
+  return sheet.sumRowWise() == expected &&
+         sheet.sumColumnWise() == expectedColumns;
+}
+static_assert(checkTallProducts());
+
+// Column of length digits against its value read 19 digits at a time from
+// the top. Columns of thousands of digits are checked at run time, past the
+// constant evaluation limits.
+constexpr bool checkLongColumn(size_t length) {
+  using Digits = utils::RepDigits<uint64_t>;
+  WideNumber number{};
+  utils::BigUnsigned expected{};
+  for (size_t first{0}; first < length; first += maxNarrowDigits) {
+    auto end = std::min(first + maxNarrowDigits, length);
+    uint64_t chunk{0};
+    for (auto idx = first; idx < end; ++idx) {
+      auto digit = static_cast<char>('1' + idx * 7 % 9);
+      number.addDigit(digit);
+      chunk = chunk * 10 + static_cast<uint64_t>(digit - '0');
+    }
+    expected = expected * utils::BigUnsigned{Digits::powers[end - first]} +
+               utils::BigUnsigned{chunk};
+  }
+  return number.isNarrow() == (length <= maxNarrowDigits) &&
+         number.get() == expected;
+}
+// With and without a partial last chunk
+static_assert(checkLongColumn(19) && checkLongColumn(20) &&
+              checkLongColumn(608) && checkLongColumn(615));
+} // namespace detail
+
+#endif // DAY_06_WORKSHEET_HPP
@@ -0,0 +1,127 @@
+#ifndef DAY_07_BEAMS_HPP
+#define DAY_07_BEAMS_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace detail {
+inline constexpr size_t wordBits{64};
+
+constexpr size_t getNbWords(size_t width) {
+  return (width + wordBits - 1) / wordBits;
+}
+
+// Sets the bit of every column of line holding c, column i being bit i % 64
+// of word i / 64. Words are expected cleared.
+constexpr void packColumns(std::string_view line, char c,
+                           std::span<uint64_t> words) {
+  size_t column{0};
+#if defined(__AVX2__)
+  if !consteval {
+    auto pattern = _mm256_set1_epi8(c);
+    for (; column + 32 <= line.size(); column += 32) {
+      auto chunk = _mm256_loadu_si256(
+          reinterpret_cast<__m256i const *>(line.data() + column));
+      auto mask = static_cast<uint32_t>(
+          _mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, pattern)));
+      words[column / wordBits] |= uint64_t{mask} << (column % wordBits);
+    }
+  }
+#endif
+  for (; column < line.size(); ++column)
+    words[column / wordBits] |= uint64_t{line[column] == c}
+                                << (column % wordBits);
+}
+} // namespace detail
+
+// Columns holding a beam, one bit per column. A row of splitters moves every
+// beam hitting a splitter to both neighbouring columns, which on the packed
+// row is (beams & ~hits) | (hits << 1) | (hits >> 1) with hits the beams
+// on a splitter, the shifts carrying bits across words.
+class BeamRow {
+public:
+  // Beams start below the 'S' of the first line
+  constexpr explicit BeamRow(std::string_view startLine)
+      : width{startLine.size()}, beams(detail::getNbWords(width), 0),
+        hits(beams.size(), 0) {
+    detail::packColumns(startLine, 'S', beams);
+  }
+
+  constexpr size_t getWidth() const { return width; }
+
+  // Moves the beams through line, returns the number of beams split
+  constexpr size_t propagate(std::string_view line) {
+    std::ranges::fill(hits, 0);
+    detail::packColumns(line.substr(0, std::min(line.size(), width)), '^',
+                        hits);
+    size_t nbSplits{0};
+    for (size_t idx{0}; idx < hits.size(); ++idx) {
+      hits[idx] &= beams[idx];
+      nbSplits += static_cast<size_t>(std::popcount(hits[idx]));
+    }
+    if (nbSplits == 0)
+      return 0;
+    uint64_t previous{0};
+    for (size_t idx{0}; idx < hits.size(); ++idx) {
+      auto current = hits[idx];
+      auto following = idx + 1 < hits.size() ? hits[idx + 1] : 0;
+      beams[idx] = (beams[idx] & ~current) | (current << 1) |
+                   (previous >> (detail::wordBits - 1)) | (current >> 1) |
+                   (following << (detail::wordBits - 1));
+      previous = current;
+    }
+    // A beam split on the last column leaves the grid
+    if (auto tail = width % detail::wordBits; tail != 0)
+      beams.back() &= (uint64_t{1} << tail) - 1;
+    return nbSplits;
+  }
+
+  constexpr size_t countBeams() const {
+    size_t res{0};
+    for (auto word : beams)
+      res += static_cast<size_t>(std::popcount(word));
+    return res;
+  }
+
+private:
+  size_t width;
+  std::vector<uint64_t> beams;
+  // Splitters of the current line, then the beams on them
+  std::vector<uint64_t> hits;
+};
+
+namespace detail {
+// Beams crossing word boundaries both ways, and leaving the grid
+constexpr bool checkBeamRow() {
+  std::string wide(130, '.');
+  wide[64] = 'S';
+  BeamRow row{wide};
+  std::ranges::fill(wide, '.');
+  wide[64] = '^';
+  if (row.propagate(wide) != 1 || row.countBeams() != 2)
+    return false;
+  wide[64] = '.';
+  wide[63] = '^';
+  wide[65] = '^';
+  if (row.propagate(wide) != 2 || row.countBeams() != 3)
+    return false;
+  std::string narrow{"S.."};
+  BeamRow edge{narrow};
+  return edge.propagate("^..") == 1 && edge.countBeams() == 1 &&
+         edge.propagate(".^.") == 1 && edge.countBeams() == 2 &&
+         edge.propagate("..^") == 1 && edge.countBeams() == 2;
+}
+static_assert(checkBeamRow());
+} // namespace detail
+
+#endif // DAY_07_BEAMS_HPP
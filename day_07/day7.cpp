@@ -1,9 +1,14 @@
+#include "beams.hpp"
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
+#include "utils/random.hpp"
+#include "utils/scan.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
 #include <iostream>
 #include <ranges>
+#include <string>
 #include <vector>
 
 constexpr size_t getSplits(std::ranges::view auto &&lines) {
@@ -43,6 +48,18 @@ constexpr size_t getSplits(std::ranges::view auto &&lines) {
   return nbSplits;
 }
 
+// Same on bit-packed rows, 64 columns per word
+constexpr size_t getSplitsPacked(std::ranges::view auto &&lines) {
+  auto line = std::ranges::begin(lines);
+  if (line == std::ranges::end(lines))
+    return 0;
+  BeamRow beams{*line};
+  size_t nbSplits{0};
+  for (++line; line != std::ranges::end(lines); ++line)
+    nbSplits += beams.propagate(*line);
+  return nbSplits;
+}
+
 constexpr std::string_view example{".......S.......\n"
                                    "...............\n"
                                    ".......^.......\n"
@@ -60,10 +77,81 @@ constexpr std::string_view example{".......S.......\n"
                                    ".^.^.^.^.^...^.\n"
                                    "..............."};
 
-static_assert(getSplits(example | std::views::split('\n')) == 21);
+static_assert(getSplits(utils::splitLines(example)) == 21);
+static_assert(getSplitsPacked(utils::splitLines(example)) == 21);
+
+#ifdef AOC_BENCH
+namespace {
+utils::bench::Registration const benchSplits{
+    "day7/getSplits",
+    [](size_t scale) {
+      // The start line once, then the splitter rows over and over
+      auto bodyStart = example.find('\n') + 1;
+      return std::string{example.substr(0, bodyStart)} +
+             utils::bench::repeatLines(example.substr(bodyStart), scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      return getSplits(utils::bench::getLines(input));
+    }};
+
+utils::bench::Registration const benchPacked{
+    "day7/getSplitsPacked",
+    [](size_t scale) {
+      auto bodyStart = example.find('\n') + 1;
+      return std::string{example.substr(0, bodyStart)} +
+             utils::bench::repeatLines(example.substr(bodyStart), scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      return getSplitsPacked(utils::bench::getLines(input));
+    }};
+
+// The example tiled in a square, so that rows get thousands of columns wide
+std::string makeWideGrid(size_t scale) {
+  return utils::bench::tileGrid(example, scale);
+}
+
+utils::bench::Registration const benchWideSplits{
+    "day7/getSplitsWide", makeWideGrid,
+    [](std::string_view input) -> uint64_t {
+      return getSplits(utils::bench::getLines(input));
+    }};
+
+utils::bench::Registration const benchWidePacked{
+    "day7/getSplitsPackedWide", makeWideGrid,
+    [](std::string_view input) -> uint64_t {
+      return getSplitsPacked(utils::bench::getLines(input));
+    }};
+
+// The static_asserts only reach the scalar packing, the SIMD one is checked
+// here on random grids against the reference. The widths leave a partial
+// group of 32 columns, or put beams on both sides of word boundaries.
+utils::bench::CheckRegistration const checkPacked{
+    "day7/getSplitsPacked", [] {
+      utils::Random random{24};
+      for (size_t width : {1, 31, 32, 63, 64, 65, 97, 130, 200}) {
+        for (size_t i{0}; i < 50; ++i) {
+          std::string grid(width, '.');
+          grid[random.between(0, width - 1)] = 'S';
+          for (auto nbRows = random.between(1, 100); nbRows > 0; --nbRows) {
+            grid += '\n';
+            for (size_t column{0}; column < width; ++column)
+              grid += random.chance(1, 4) ? '^' : '.';
+          }
+          if (getSplitsPacked(utils::splitLines(grid)) !=
+              getSplits(utils::splitLines(grid)))
+            return false;
+        }
+      }
+      return true;
+    }};
+} // namespace
 
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
-  auto getRes = getSplits(utils::getLines());
+  // One line at a time, a piped grid is never gathered in memory
+  auto getRes = getSplitsPacked(utils::getLines());
   std::cout << "Res: " << getRes << '\n';
   return 0;
 }
+#endif
@@ -1,4 +1,8 @@
+#include "timelines.hpp"
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
+#include "utils/random.hpp"
+#include "utils/scan.hpp"
 #include <algorithm>
 #include <cstddef>
 #include <cstdint>
@@ -8,6 +12,8 @@
 #include <iterator>
 #include <numeric>
 #include <ranges>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 constexpr size_t getSplits(std::ranges::view auto &&lines) {
@@ -45,6 +51,41 @@ constexpr size_t getSplits(std::ranges::view auto &&lines) {
                      std::plus<>{});
 }
 
+// Same on vectorised counter lanes, as wide as counting asks for
+constexpr utils::BigUnsigned
+countTimelines(std::ranges::view auto &&lines,
+               Counting counting = Counting::Exact) {
+  auto line = std::ranges::begin(lines);
+  auto end = std::ranges::end(lines);
+  if (line == end)
+    return {};
+  if (counting == Counting::Modular) {
+    CounterLanes<1, true> lanes{*line};
+    for (++line; line != end; ++line)
+      lanes.propagate(*line);
+    return getTotal(lanes, counting);
+  }
+  if (counting == Counting::Checked) {
+    CounterLanes<1> lanes{*line};
+    for (++line; line != end; ++line)
+      if (!lanes.propagate(*line))
+        throw std::overflow_error{"Timeline count exceeds 64 bits"};
+    return getTotal(lanes, counting);
+  }
+  CounterLanes<2> lanes{*line};
+  for (++line; line != end; ++line) {
+    if (lanes.propagate(*line))
+      continue;
+    if (counting == Counting::Wide)
+      throw std::overflow_error{"Timeline count exceeds 128 bits"};
+    ExactLanes exact{lanes};
+    for (; line != end; ++line)
+      exact.propagate(*line);
+    return exact.getTotal();
+  }
+  return getTotal(lanes, counting);
+}
+
 constexpr std::string_view example{".......S.......\n"
                                    "...............\n"
                                    ".......^.......\n"
@@ -62,10 +103,147 @@ constexpr std::string_view example{".......S.......\n"
                                    ".^.^.^.^.^...^.\n"
                                    "..............."};
 
-static_assert(getSplits(example | std::views::split('\n')) == 40);
+static_assert(getSplits(utils::splitLines(example)) == 40);
+static_assert(countTimelines(utils::splitLines(example), Counting::Checked) ==
+              40);
+static_assert(countTimelines(utils::splitLines(example), Counting::Wide) ==
+              40);
+static_assert(countTimelines(utils::splitLines(example), Counting::Modular) ==
+              40);
+static_assert(countTimelines(utils::splitLines(example)) == 40);
+
+namespace detail {
+// Splitters on every column below the start: each column receives the
+// timelines of both of its neighbours, about 1.88 times more on every row
+constexpr std::string makeSplitterRows(size_t width, size_t nbRows) {
+  std::string res(width, '.');
+  res[width / 2] = 'S';
+  for (size_t row{0}; row < nbRows; ++row)
+    res += '\n' + std::string(width, '^');
+  return res;
+}
+
+// Same recurrence on big integers, as a reference
+constexpr utils::BigUnsigned countSplitterRows(size_t width, size_t nbRows) {
+  std::vector<utils::BigUnsigned> counts(width);
+  std::vector<utils::BigUnsigned> next(width);
+  counts[width / 2] = 1;
+  for (size_t row{0}; row < nbRows; ++row) {
+    for (size_t column{0}; column < width; ++column) {
+      next[column] = utils::BigUnsigned{};
+      if (column > 0)
+        next[column] += counts[column - 1];
+      if (column + 1 < width)
+        next[column] += counts[column + 1];
+    }
+    std::swap(counts, next);
+  }
+  return std::ranges::fold_left(counts, utils::BigUnsigned{}, std::plus<>{});
+}
+
+constexpr bool checkTallGrids() {
+  auto shallow = makeSplitterRows(8, 60);
+  if (countTimelines(utils::splitLines(shallow), Counting::Checked) !=
+      countSplitterRows(8, 60))
+    return false;
+  // Past 128 bits after about 140 rows, the last ones on big integers
+  auto tall = makeSplitterRows(8, 150);
+  auto expected = countSplitterRows(8, 150);
+  return expected.toDecimal().size() > 39 &&
+         countTimelines(utils::splitLines(tall)) == expected &&
+         countTimelines(utils::splitLines(tall), Counting::Modular) ==
+             expected.getLowBits();
+}
+static_assert(checkTallGrids());
+} // namespace detail
+
+#ifdef AOC_BENCH
+namespace {
+utils::bench::Registration const benchSplits{
+    "day7_2/getSplits",
+    [](size_t scale) {
+      // The start line once, then the splitter rows over and over
+      auto bodyStart = example.find('\n') + 1;
+      return std::string{example.substr(0, bodyStart)} +
+             utils::bench::repeatLines(example.substr(bodyStart), scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      return getSplits(utils::bench::getLines(input));
+    }};
+
+// The static_asserts only reach the scalar kernel, the SIMD one is checked
+// here: on the tall grids, with widths leaving a partial group of four
+// columns, then on random grids against the reference
+utils::bench::CheckRegistration const checkCounterLanes{
+    "day7_2/countTimelines", [] {
+      for (size_t width : {8, 13, 37}) {
+        auto tall = detail::makeSplitterRows(width, 150);
+        auto expected = detail::countSplitterRows(width, 150);
+        if (expected.getBitWidth() <= 128 ||
+            countTimelines(utils::splitLines(tall)) != expected ||
+            countTimelines(utils::splitLines(tall), Counting::Modular) !=
+                expected.getLowBits())
+          return false;
+        try {
+          countTimelines(utils::splitLines(tall), Counting::Wide);
+          return false;
+        } catch (std::overflow_error const &) {
+        }
+        auto shallow = detail::makeSplitterRows(width, 60);
+        if (countTimelines(utils::splitLines(shallow), Counting::Checked) !=
+            detail::countSplitterRows(width, 60))
+          return false;
+      }
+      utils::Random random{7};
+      for (size_t i{0}; i < 500; ++i) {
+        auto width = random.between(1, 100);
+        std::string grid(width, '.');
+        grid[random.between(0, width - 1)] = 'S';
+        for (auto nbRows = random.between(1, 60); nbRows > 0; --nbRows) {
+          grid += '\n';
+          for (size_t column{0}; column < width; ++column)
+            grid += random.chance(1, 2) ? '^' : '.';
+        }
+        if (countTimelines(utils::splitLines(grid), Counting::Checked) !=
+            getSplits(utils::splitLines(grid)))
+          return false;
+      }
+      return true;
+    }};
+
+utils::bench::Registration const benchCounterLanes{
+    "day7_2/countTimelines",
+    [](size_t scale) {
+      auto bodyStart = example.find('\n') + 1;
+      return std::string{example.substr(0, bodyStart)} +
+             utils::bench::repeatLines(example.substr(bodyStart), scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      return countTimelines(utils::bench::getLines(input), Counting::Checked)
+          .getLowBits();
+    }};
+
+utils::bench::Registration const benchWideLanes{
+    "day7_2/countTimelinesWide",
+    [](size_t scale) {
+      auto bodyStart = example.find('\n') + 1;
+      return std::string{example.substr(0, bodyStart)} +
+             utils::bench::repeatLines(example.substr(bodyStart), scale);
+    },
+    [](std::string_view input) -> uint64_t {
+      return countTimelines(utils::bench::getLines(input), Counting::Wide)
+          .getLowBits();
+    }};
+} // namespace
 
-int main() {
-  auto getRes = getSplits(utils::getLines());
-  std::cout << "Res: " << getRes << '\n';
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+// Optional argument: counting, checked, wide, modular or exact (default)
+int main(int argc, char **argv) {
+  auto counting = argc > 1 ? parseCounting(argv[1]) : Counting::Exact;
+  // One line at a time, a piped grid is never gathered in memory
+  auto getRes = countTimelines(utils::getLines(), counting);
+  std::cout << "Res: " << getRes.toDecimal() << '\n';
   return 0;
 }
+#endif
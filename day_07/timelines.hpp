@@ -0,0 +1,239 @@
+#ifndef DAY_07_TIMELINES_HPP
+#define DAY_07_TIMELINES_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/bigint.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// Width of the timeline counters
+enum class Counting {
+  // 64 bits, std::overflow_error past that
+  Checked,
+  // 128 bits, std::overflow_error past that
+  Wide,
+  // 64 bits, counts modulo 2^64
+  Modular,
+  // 128 bits, then arbitrary precision from the row that overflows them
+  Exact,
+};
+
+// Counting named on the command line
+constexpr Counting parseCounting(std::string_view name) {
+  if (name == "checked")
+    return Counting::Checked;
+  if (name == "wide")
+    return Counting::Wide;
+  if (name == "modular")
+    return Counting::Modular;
+  if (name == "exact")
+    return Counting::Exact;
+  throw std::invalid_argument{"Counting is checked, wide, modular or exact"};
+}
+
+namespace detail {
+#if defined(__AVX2__)
+// a < b on unsigned 64-bit lanes, all ones where true
+inline __m256i lessThan(__m256i a, __m256i b) {
+  auto sign = _mm256_set1_epi64x(INT64_MIN);
+  return _mm256_cmpgt_epi64(_mm256_xor_si256(b, sign),
+                            _mm256_xor_si256(a, sign));
+}
+#endif
+} // namespace detail
+
+// Number of timelines reaching each column, on counters of NbWords 64-bit
+// words stored as one plane per word. Below a row, a column keeps its count
+// unless it holds a splitter, and receives the counts of its neighbours
+// which do: next = (count & ~mask) + (left & leftMask) + (right & rightMask),
+// masks being all ones under the splitters. Planes are padded with a zero
+// column on both sides and double-buffered, neither is ever reallocated.
+template <size_t NbWords, bool Wraps = false> class CounterLanes {
+public:
+  // Timelines start below the 'S' of the first line
+  constexpr explicit CounterLanes(std::string_view startLine)
+      : width{startLine.size()}, masks(width + 2, 0) {
+    for (auto planes : {&counts, &next})
+      for (auto &plane : *planes)
+        plane.assign(width + 2, 0);
+    for (size_t column{0}; column < width; ++column)
+      counts[0][column + 1] = startLine[column] == 'S';
+  }
+
+  constexpr size_t getWidth() const { return width; }
+
+  constexpr utils::uint128 getCount(size_t column) const {
+    utils::uint128 res{counts[0][column + 1]};
+    if constexpr (NbWords > 1)
+      res |= utils::uint128{counts[1][column + 1]} << 64;
+    return res;
+  }
+
+  // Moves the counts through line, false if one overflowed. Unless Wraps,
+  // counts are then left as they were above line.
+  constexpr bool propagate(std::string_view line) {
+    if (line.find('^') == std::string_view::npos)
+      return true;
+    for (size_t column{0}; column < width; ++column)
+      masks[column + 1] =
+          column < line.size() && line[column] == '^' ? ~uint64_t{0} : 0;
+    uint64_t carries{0};
+    size_t column{1};
+#if defined(__AVX2__)
+    if !consteval {
+      carries = propagateSimd(column);
+    }
+#endif
+    for (; column <= width; ++column)
+      carries |= propagateColumn(column);
+    if (carries != 0 && !Wraps)
+      return false;
+    std::swap(counts, next);
+    return carries == 0;
+  }
+
+private:
+  // Count of one column below the row, returns the carry out of the top word
+  constexpr uint64_t propagateColumn(size_t column) {
+    uint64_t carry{0};
+    for (size_t word{0}; word < NbWords; ++word) {
+      auto const &plane = counts[word];
+      auto keep = plane[column] & ~masks[column];
+      auto left = plane[column - 1] & masks[column - 1];
+      auto right = plane[column + 1] & masks[column + 1];
+      auto sum = keep + left;
+      uint64_t nextCarry = sum < keep;
+      sum += right;
+      nextCarry += sum < right;
+      sum += carry;
+      nextCarry += sum < carry;
+      next[word][column] = sum;
+      carry = nextCarry;
+    }
+    return carry;
+  }
+
+#if defined(__AVX2__)
+  // Same on four columns at a time from column, which is moved past them
+  uint64_t propagateSimd(size_t &column) {
+    auto zero = _mm256_setzero_si256();
+    auto overflows = zero;
+    for (; column + 4 <= width + 1; column += 4) {
+      auto load = [column](std::vector<uint64_t> const &values,
+                           size_t offset) {
+        return _mm256_loadu_si256(
+            reinterpret_cast<__m256i const *>(values.data() + column - 1 +
+                                              offset));
+      };
+      auto mask = load(masks, 1);
+      auto leftMask = load(masks, 0);
+      auto rightMask = load(masks, 2);
+      auto carries = zero;
+      for (size_t word{0}; word < NbWords; ++word) {
+        auto keep = _mm256_andnot_si256(mask, load(counts[word], 1));
+        auto left = _mm256_and_si256(leftMask, load(counts[word], 0));
+        auto right = _mm256_and_si256(rightMask, load(counts[word], 2));
+        // Carries count down from 0, lessThan being -1 where true
+        auto sum = _mm256_add_epi64(keep, left);
+        auto nextCarries = detail::lessThan(sum, keep);
+        sum = _mm256_add_epi64(sum, right);
+        nextCarries = _mm256_add_epi64(nextCarries,
+                                       detail::lessThan(sum, right));
+        auto carried = _mm256_sub_epi64(sum, carries);
+        nextCarries = _mm256_add_epi64(
+            nextCarries, detail::lessThan(carried, sum));
+        _mm256_storeu_si256(
+            reinterpret_cast<__m256i *>(next[word].data() + column), carried);
+        carries = nextCarries;
+      }
+      overflows = _mm256_or_si256(overflows, carries);
+    }
+    return !_mm256_testz_si256(overflows, overflows);
+  }
+#endif
+
+  size_t width;
+  std::array<std::vector<uint64_t>, NbWords> counts{};
+  std::array<std::vector<uint64_t>, NbWords> next{};
+  // All ones under the splitters of the current line
+  std::vector<uint64_t> masks;
+};
+
+// Same on arbitrary-precision counters, for the rows past 128 bits
+class ExactLanes {
+public:
+  template <size_t NbWords, bool Wraps>
+  constexpr explicit ExactLanes(CounterLanes<NbWords, Wraps> const &lanes)
+      : counts(lanes.getWidth()), next(lanes.getWidth()) {
+    for (size_t column{0}; column < counts.size(); ++column)
+      counts[column] = utils::BigUnsigned{lanes.getCount(column)};
+  }
+
+  constexpr void propagate(std::string_view line) {
+    auto isSplitter = [line](size_t column) {
+      return column < line.size() && line[column] == '^';
+    };
+    for (size_t column{0}; column < counts.size(); ++column) {
+      auto &count = next[column];
+      if (isSplitter(column))
+        count = utils::BigUnsigned{};
+      else
+        count = counts[column];
+      if (column > 0 && isSplitter(column - 1))
+        count += counts[column - 1];
+      if (column + 1 < counts.size() && isSplitter(column + 1))
+        count += counts[column + 1];
+    }
+    std::swap(counts, next);
+  }
+
+  constexpr utils::BigUnsigned getTotal() const {
+    utils::BigUnsigned res{};
+    for (auto const &count : counts)
+      res += count;
+    return res;
+  }
+
+private:
+  std::vector<utils::BigUnsigned> counts;
+  std::vector<utils::BigUnsigned> next;
+};
+
+// Sum of the counts of lanes, within the limits of counting
+template <size_t NbWords, bool Wraps>
+constexpr utils::BigUnsigned
+getTotal(CounterLanes<NbWords, Wraps> const &lanes, Counting counting) {
+  if (counting == Counting::Modular) {
+    uint64_t total{0};
+    for (size_t column{0}; column < lanes.getWidth(); ++column)
+      total += static_cast<uint64_t>(lanes.getCount(column));
+    return utils::BigUnsigned{total};
+  }
+  utils::uint128 total{0};
+  utils::BigUnsigned spill{};
+  for (size_t column{0}; column < lanes.getWidth(); ++column) {
+    auto count = lanes.getCount(column);
+    utils::uint128 sum;
+    if (__builtin_add_overflow(total, count, &sum)) {
+      if (counting != Counting::Exact)
+        throw std::overflow_error{"Timeline count exceeds 128 bits"};
+      spill += utils::BigUnsigned{total} + utils::BigUnsigned{count};
+      sum = 0;
+    }
+    total = sum;
+  }
+  if (counting == Counting::Checked && total > ~uint64_t{0})
+    throw std::overflow_error{"Timeline count exceeds 64 bits"};
+  return spill + utils::BigUnsigned{total};
+}
+
+#endif // DAY_07_TIMELINES_HPP
@@ -1,3 +1,4 @@
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
 #include "utils/parser.hpp"
 #include <algorithm>
@@ -104,11 +105,7 @@ constexpr size_t sqDist(coord_t const &c0, coord_t const &c1) {
 constexpr coord_t fromLine(std::string_view sv) {
   utils::Parser p(sv);
   coord_t res{};
-  res[0] = p.getUnsignedInt();
-  p.drop(1);
-  res[1] = p.getUnsignedInt();
-  p.drop(1);
-  res[2] = p.getUnsignedInt();
+  p.parseUnsignedInts(res);
   return res;
 }
 
@@ -191,8 +188,29 @@ constexpr size_t getGroups(std::ranges::view auto &&views) {
                      std::multiplies<>{});
 }
 
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{
+    "162,817,812\n57,618,57\n906,360,560\n592,479,940\n352,342,300\n"
+    "466,668,158\n542,29,236\n431,825,988\n739,650,466\n52,470,668\n"
+    "216,146,977\n819,987,18\n117,168,530\n805,96,715\n346,949,466\n"
+    "970,615,88\n941,993,340\n862,61,35\n984,92,344\n425,690,689\n"};
+
+// Quadratic in the number of boxes
+utils::bench::Registration const benchGroups{
+    "day8/getGroups",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return getGroups(utils::bench::getLines(input));
+    },
+    100};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
   auto res = getGroups(utils::getLines());
   std::cout << "Result is: " << res << '\n';
   return 0;
 }
+#endif
@@ -64,11 +64,7 @@ constexpr size_t sqDist(coord_t const &c0, coord_t const &c1) {
 constexpr coord_t fromLine(std::string_view sv) {
   utils::Parser p(sv);
   coord_t res{};
-  res[0] = p.getUnsignedInt();
-  p.drop(1);
-  res[1] = p.getUnsignedInt();
-  p.drop(1);
-  res[2] = p.getUnsignedInt();
+  p.parseUnsignedInts(res);
   return res;
 }
 
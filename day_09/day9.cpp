@@ -1,4 +1,5 @@
 
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
 #include <array>
 #include <charconv>
@@ -71,8 +72,26 @@ constexpr std::array<coord_t, 8> example{
 
 static_assert(getMaxArea(example | std::views::all) == 50);
 
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view exampleText{
+    "7,1\n11,1\n11,7\n9,7\n9,5\n2,5\n2,3\n7,3\n"};
+
+// Quadratic in the number of distinct x
+utils::bench::Registration const benchMaxArea{
+    "day9/getMaxArea",
+    [](size_t scale) { return utils::bench::repeatLines(exampleText, scale); },
+    [](std::string_view input) -> uint64_t {
+      return getMaxArea(utils::bench::getLines(input) |
+                        std::views::transform(getFromView));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
   size_t res =
       getMaxArea(utils::getLines() | std::views::transform(getFromView));
   std::cout << "Res: " << res << '\n';
 }
+#endif
@@ -1,3 +1,4 @@
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
 #include <algorithm>
 #include <array>
@@ -91,11 +92,33 @@ struct Machine {
   }
 };
 
-int main() {
+size_t getTotalClicks(std::ranges::view auto &&lines) {
   size_t res{0};
-  for (auto const &machine :
-       utils::getLines() | std::views::transform(Machine::from))
+  for (auto const &machine : lines | std::views::transform(Machine::from))
     res += machine.getNbClicks();
+  return res;
+}
+
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view example{
+    "[.##.] (3) (1,3) (2) (2,3) (0,2) (0,1) {3,5,4,7}\n"
+    "[...#.] (0,2,3,4) (2,3) (0,4) (0,1,2) (1,2,3,4) {7,5,12,7,2}\n"
+    "[.###.#] (0,1,2,3,4) (0,3,4) (0,1,2,4,5) (1,2) {10,11,11,5,10,5}\n"};
+
+utils::bench::Registration const benchClicks{
+    "day10/getNbClicks",
+    [](size_t scale) { return utils::bench::repeatLines(example, scale); },
+    [](std::string_view input) -> uint64_t {
+      return getTotalClicks(utils::bench::getLines(input));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
+int main() {
+  auto res = getTotalClicks(utils::getLines());
   std::cout << std::format("Res: {}\n", res);
   return 0;
 }
+#endif
@@ -1,4 +1,6 @@
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
+#include <format>
 #include <optional>
 #include <ranges>
 #include <span>
@@ -77,9 +79,9 @@ public:
   }
 };
 
-size_t getValues() {
+size_t getValues(std::ranges::view auto &&lines) {
   Graph g;
-  for (auto sv : utils::getLines()) {
+  for (auto sv : lines) {
     auto splitPos = sv.find(':');
     auto name = std::string(sv.begin(), sv.begin() + splitPos);
     auto nodes = std::ranges::to<std::vector>(
@@ -93,8 +95,42 @@ size_t getValues() {
   return g.countPath("you", "out");
 }
 
+#ifdef AOC_BENCH
+namespace {
+// Example graph with node names suffixed by {0}; {1} and {2} stand for its
+// "you" and "out" nodes, so that copies can be chained one after the other.
+constexpr std::string_view exampleTemplate{
+    "aaa{0}: {1} hhh{0}\n{1}: bbb{0} ccc{0}\nbbb{0}: ddd{0} eee{0}\n"
+    "ccc{0}: ddd{0} eee{0} fff{0}\nddd{0}: ggg{0}\neee{0}: {2}\n"
+    "fff{0}: {2}\nggg{0}: {2}\nhhh{0}: ccc{0} fff{0} iii{0}\niii{0}: {2}\n"};
+
+utils::bench::Registration const benchCountPath{
+    "day11/countPath",
+    [](size_t scale) {
+      std::string res{};
+      auto getLink = [scale](size_t copy) {
+        if (copy == 0)
+          return std::string{"you"};
+        if (copy == scale)
+          return std::string{"out"};
+        return std::format("you{}", copy);
+      };
+      for (size_t copy{0}; copy < scale; ++copy) {
+        res += std::format(exampleTemplate, copy, getLink(copy),
+                           getLink(copy + 1));
+      }
+      return res;
+    },
+    [](std::string_view input) -> uint64_t {
+      return getValues(utils::bench::getLines(input));
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
-  auto res = getValues();
+  auto res = getValues(utils::getLines());
   std::cout << std::format("Res is {}\n", res);
   return 0;
 }
+#endif
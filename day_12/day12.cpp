@@ -1,3 +1,4 @@
+#include "utils/bench.hpp"
 #include "utils/io.hpp"
 #include "utils/parser.hpp"
 #include <array>
@@ -76,6 +77,23 @@ public:
   }
 };
 
+Problem::TreeArea parseTreeArea(std::string_view view) {
+  utils::Parser parser{view};
+  auto width = parser.getUnsigned<size_t>();
+  parser.eat('x');
+  auto height = parser.getUnsigned<size_t>();
+  parser.eat(':');
+  auto counts = std::ranges::to<std::vector>(
+      parser.remain() | std::views::split(' ') |
+      std::views::filter([](auto const &val) { return !val.empty(); }) |
+      std::views::transform([&](auto const &range) {
+        size_t count{0};
+        std::from_chars(range.begin(), range.end(), count);
+        return count;
+      }));
+  return {width, height, std::move(counts)};
+}
+
 class ProblemParser {
   Problem problem;
   void ParseShapes() {
@@ -88,19 +106,7 @@ class ProblemParser {
   }
 
   void ParseTreeArea(std::string_view view) {
-    utils::Parser parser{view};
-    auto width = parser.getUnsignedInt();
-    parser.eat('x');
-    auto height = parser.getUnsignedInt();
-    parser.eat(':');
-    auto counts = std::ranges::to<std::vector>(
-        parser.remain() | std::views::split(' ') |
-        std::views::filter([](auto const &val) { return !val.empty(); }) |
-        std::views::transform([&](auto const &range) {
-          size_t count{0};
-          std::from_chars(range.begin(), range.end(), count);
-          return count;
-        }));
+    auto [width, height, counts] = parseTreeArea(view);
     problem.addTreeArea(width, height, std::move(counts));
   }
 
@@ -110,7 +116,7 @@ public:
       if (sv.empty())
         continue;
       utils::Parser parser{sv};
-      std::ignore = parser.getUnsignedInt();
+      std::ignore = parser.getUnsigned<size_t>();
       if (*parser.remain().begin() == ':') {
         ParseShapes();
       } else {
@@ -149,7 +155,40 @@ void solveInstance() {
                                Problem::QuickCheckResultFits::No)]);
 }
 
+#ifdef AOC_BENCH
+namespace {
+constexpr std::string_view exampleAreas{"4x4: 0 0 0 0 2 0\n"
+                                        "12x5: 1 0 1 0 2 2\n"
+                                        "12x5: 1 0 1 0 3 2\n"};
+
+utils::bench::Registration const benchQuickCheck{
+    "day12/quickCheckFits",
+    [](size_t scale) { return utils::bench::repeatLines(exampleAreas, scale); },
+    [](std::string_view input) -> uint64_t {
+      Problem problem{};
+      for (auto const &shape : std::array<std::array<std::string, 3>, 6>{
+               {{"###", "##.", "##."},
+                {"###", "##.", ".##"},
+                {".##", "###", "##."},
+                {"##.", "###", "##."},
+                {"###", "#..", "###"},
+                {"###", ".#.", "###"}}}) {
+        problem.addShape(shape);
+      }
+      uint64_t nbFits{0};
+      for (auto line : utils::bench::getLines(input)) {
+        auto treeArea = parseTreeArea(line);
+        nbFits += problem.quickCheckFits(treeArea) ==
+                  Problem::QuickCheckResultFits::Yes;
+      }
+      return nbFits;
+    }};
+} // namespace
+
+int main(int argc, char **argv) { return utils::bench::runAll(argc, argv); }
+#else
 int main() {
   solveInstance();
   return 0;
 }
+#endif
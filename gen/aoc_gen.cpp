@@ -0,0 +1,488 @@
+#include "utils/random.hpp"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fcntl.h>
+#include <format>
+#include <iostream>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+// Synthetic puzzle inputs, valid for the solvers of each day.
+// Usage: aoc_gen <day> [--size N] [--width N] [--seed N] [--output FILE]
+// Output is deterministic for a given seed.
+
+namespace {
+// Buffered writer straight to a file descriptor
+class Output {
+public:
+  static constexpr size_t capacity{size_t{1} << 20};
+
+  explicit Output(int fd) : fd(fd), buffer(capacity) {}
+
+  Output(Output const &) = delete;
+  Output &operator=(Output const &) = delete;
+
+  Output &operator<<(char c) {
+    reserve(1);
+    buffer[used++] = c;
+    return *this;
+  }
+
+  Output &operator<<(std::string_view sv) {
+    if (sv.size() > capacity) {
+      flush();
+      writeAll(sv.data(), sv.size());
+      return *this;
+    }
+    reserve(sv.size());
+    std::ranges::copy(sv, buffer.data() + used);
+    used += sv.size();
+    return *this;
+  }
+
+  Output &operator<<(std::unsigned_integral auto value) {
+    reserve(20);
+    auto [end, ec] =
+        std::to_chars(buffer.data() + used, buffer.data() + capacity, value);
+    used = static_cast<size_t>(end - buffer.data());
+    return *this;
+  }
+
+  void flush() {
+    writeAll(buffer.data(), used);
+    used = 0;
+  }
+
+private:
+  void reserve(size_t size) {
+    if (capacity - used < size)
+      flush();
+  }
+
+  void writeAll(char const *data, size_t size) {
+    while (size != 0) {
+      auto nbWritten = write(fd, data, size);
+      if (nbWritten == -1) {
+        if (errno == EINTR)
+          continue;
+        throw std::system_error(errno, std::generic_category(), "write");
+      }
+      data += nbWritten;
+      size -= static_cast<size_t>(nbWritten);
+    }
+  }
+
+  int fd;
+  std::vector<char> buffer;
+  size_t used{0};
+};
+
+struct Options {
+  size_t size;
+  size_t width;
+};
+
+using utils::Random;
+
+char randomDigit(Random &rng) {
+  return static_cast<char>('0' + rng.between(1, 9));
+}
+
+// Fills line from random bytes, 8 per draw, for the bulk grid-like inputs.
+// The slight bias of pick on a byte does not matter there.
+void fillFromBytes(std::span<char> line, Random &rng, auto pick) {
+  uint64_t bits{0};
+  for (size_t i{0}; i < line.size(); ++i) {
+    if (i % 8 == 0)
+      bits = rng();
+    line[i] = pick(static_cast<uint8_t>(bits));
+    bits >>= 8;
+  }
+}
+
+// Rotations of the dial, of at most width clicks
+void genDay1(Output &out, Random &rng, Options const &opt) {
+  auto maxClicks = std::max(opt.width, size_t{1});
+  for (size_t i{0}; i < opt.size; ++i)
+    out << (rng.chance(1, 2) ? 'L' : 'R') << rng.between(1, maxClicks) << '\n';
+}
+
+// One line of comma separated ID ranges, of up to 10 digits
+void genDay2(Output &out, Random &rng, Options const &opt) {
+  constexpr uint64_t maxId{9'999'999'999};
+  for (size_t i{0}; i < opt.size; ++i) {
+    auto nbDigits = rng.between(1, 10);
+    uint64_t low{1};
+    for (uint64_t d{1}; d < nbDigits; ++d)
+      low *= 10;
+    auto start = rng.between(low, low * 10 - 1);
+    auto length = rng.between(0, std::min(low, opt.width));
+    auto end = std::min(maxId, start + length);
+    if (i != 0)
+      out << ',';
+    out << start << '-' << end;
+  }
+  out << '\n';
+}
+
+// Battery banks of width joltages
+void genDay3(Output &out, Random &rng, Options const &opt) {
+  std::string line(opt.width + 1, '\n');
+  for (size_t i{0}; i < opt.size; ++i) {
+    fillFromBytes(std::span{line}.first(opt.width), rng, [](uint8_t byte) {
+      return static_cast<char>('1' + byte * 9 / 256);
+    });
+    out << line;
+  }
+}
+
+// Grid of paper rolls, about 3 cells out of 5 are occupied
+void genDay4(Output &out, Random &rng, Options const &opt) {
+  std::string line(opt.width + 1, '\n');
+  for (size_t i{0}; i < opt.size; ++i) {
+    fillFromBytes(std::span{line}.first(opt.width), rng,
+                  [](uint8_t byte) { return byte < 154 ? '@' : '.'; });
+    out << line;
+  }
+}
+
+// size fresh ranges, then 5 times as many ingredient IDs
+void genDay5(Output &out, Random &rng, Options const &opt) {
+  constexpr uint64_t maxId{999'999'999'999'999};
+  auto maxLength = maxId / std::max(opt.size, size_t{1});
+  for (size_t i{0}; i < opt.size; ++i) {
+    auto start = rng.between(1, maxId);
+    out << start << '-' << std::min(maxId, start + rng.between(0, maxLength))
+        << '\n';
+  }
+  out << '\n';
+  for (size_t i{0}; i < 5 * opt.size; ++i)
+    out << rng.between(1, maxId) << '\n';
+}
+
+// size problems of width operands, each problem with its own alignment.
+// Up to 19 operands, products fit in 64 bits whether operands are read along
+// rows or down columns; taller sheets have column operands of width digits,
+// past 64 bits from 20 rows on, for the wide and exact arithmetic.
+// Rows are written as they are drawn, only the problem shapes are kept.
+void genDay6(Output &out, Random &rng, Options const &opt) {
+  auto nbRows = std::max(opt.width, size_t{1});
+  auto maxDigits = std::clamp(size_t{19} / nbRows, size_t{1}, size_t{4});
+  struct Problem {
+    size_t nbDigits;
+    bool alignLeft;
+    char op;
+    // Row of the operand spanning the whole width of the problem
+    size_t fullRow;
+  };
+  std::vector<Problem> problems(opt.size);
+  for (auto &problem : problems) {
+    problem = {rng.between(1, maxDigits), rng.chance(1, 2),
+               rng.chance(1, 2) ? '+' : '*', rng.between(0, nbRows - 1)};
+  }
+  std::string operand{};
+  for (size_t rowIdx{0}; rowIdx < nbRows; ++rowIdx) {
+    for (auto [index, problem] : problems | std::views::enumerate) {
+      auto nbDigits = rowIdx == problem.fullRow
+                          ? problem.nbDigits
+                          : rng.between(1, problem.nbDigits);
+      operand.assign(problem.nbDigits, ' ');
+      auto padding = problem.alignLeft ? 0 : problem.nbDigits - nbDigits;
+      std::generate_n(operand.begin() + static_cast<std::ptrdiff_t>(padding),
+                      nbDigits, [&] { return randomDigit(rng); });
+      if (index != 0)
+        out << ' ';
+      out << operand;
+    }
+    out << '\n';
+  }
+  for (auto [index, problem] : problems | std::views::enumerate) {
+    if (index != 0)
+      out << ' ';
+    out << problem.op << std::string(problem.nbDigits - 1, ' ');
+  }
+  out << '\n';
+}
+
+// Beam source on the first line, then size empty/splitter line pairs.
+// Splitters stay off the borders and never touch each other: on each
+// splitter line they sit every other column, alternating like the beams.
+void genDay7(Output &out, Random &rng, Options const &opt) {
+  auto width = std::max(opt.width, size_t{3});
+  auto source = width / 2;
+  std::string line(width + 1, '.');
+  line.back() = '\n';
+  std::string emptyLine{line};
+  line[source] = 'S';
+  out << line;
+  for (size_t i{0}; i < opt.size; ++i) {
+    out << emptyLine;
+    for (size_t col{1}; col + 1 < width; ++col) {
+      auto onGrid = (col + i + source) % 2 == 0;
+      line[col] = onGrid && rng.chance(1, 2) ? '^' : '.';
+    }
+    out << line;
+  }
+}
+
+// Junction boxes, coordinates below width
+void genDay8(Output &out, Random &rng, Options const &opt) {
+  auto maxCoord = std::max(opt.width, size_t{1}) - 1;
+  for (size_t i{0}; i < opt.size; ++i) {
+    out << rng.between(0, maxCoord) << ',' << rng.between(0, maxCoord) << ','
+        << rng.between(0, maxCoord) << '\n';
+  }
+}
+
+// Red tiles on the outline of an x-monotone rectilinear polygon of about
+// size vertices: every column of the polygon crosses the middle row.
+void genDay9(Output &out, Random &rng, Options const &opt) {
+  auto nbColumns = std::max(opt.size / 4, size_t{1});
+  auto height = std::max(opt.width, size_t{4});
+  auto middle = height / 2;
+  auto maxStep = std::max(opt.width / nbColumns, size_t{1}) * 2;
+  std::vector<uint64_t> xs{rng.between(0, maxStep)};
+  std::vector<uint64_t> tops{};
+  std::vector<uint64_t> bottoms{};
+  for (size_t i{0}; i < nbColumns; ++i) {
+    xs.push_back(xs.back() + rng.between(1, maxStep));
+    uint64_t top;
+    uint64_t bottom;
+    do {
+      top = rng.between(middle + 1, height - 1);
+    } while (!tops.empty() && tops.back() == top);
+    do {
+      bottom = rng.between(0, middle - 1);
+    } while (!bottoms.empty() && bottoms.back() == bottom);
+    tops.push_back(top);
+    bottoms.push_back(bottom);
+  }
+  auto emit = [&](uint64_t x, uint64_t y) { out << x << ',' << y << '\n'; };
+  for (size_t i{0}; i < nbColumns; ++i) {
+    emit(xs[i], tops[i]);
+    emit(xs[i + 1], tops[i]);
+  }
+  for (size_t i{nbColumns}; i-- > 0;) {
+    emit(xs[i + 1], bottoms[i]);
+    emit(xs[i], bottoms[i]);
+  }
+}
+
+// Machines of up to 10 lights and 12 buttons. Both the light pattern and
+// the joltages are reachable from a random set of presses.
+void genDay10(Output &out, Random &rng, Options const &opt) {
+  for (size_t i{0}; i < opt.size; ++i) {
+    auto nbLights = rng.between(3, 10);
+    auto nbButtons = rng.between(3, 12);
+    uint64_t lights{0};
+    std::vector<uint64_t> joltages(nbLights, 0);
+    std::vector<uint64_t> buttons(nbButtons);
+    for (auto &button : buttons) {
+      button = rng.between(1, (uint64_t{1} << nbLights) - 1);
+      auto nbPresses = rng.between(0, 15);
+      if (nbPresses % 2 == 1)
+        lights ^= button;
+      for (size_t light{0}; light < nbLights; ++light)
+        joltages[light] += (button >> light & 1) * nbPresses;
+    }
+    out << '[';
+    for (size_t light{0}; light < nbLights; ++light)
+      out << ((lights >> light & 1) != 0 ? '#' : '.');
+    out << ']';
+    for (auto button : buttons) {
+      out << " (";
+      auto first{true};
+      for (size_t light{0}; light < nbLights; ++light) {
+        if ((button >> light & 1) == 0)
+          continue;
+        if (!first)
+          out << ',';
+        out << light;
+        first = false;
+      }
+      out << ')';
+    }
+    out << " {";
+    for (auto [index, joltage] : joltages | std::views::enumerate)
+      out << (index == 0 ? "" : ",") << joltage;
+    out << "}\n";
+  }
+}
+
+// Device DAG of size nodes, listed in topological order. Every node links to
+// the next one: that spine runs from svr through you, fft then dac to out,
+// so paths between them always exist. The other edges only go a few nodes
+// forward, which keeps the paths long.
+void genDay11(Output &out, Random &rng, Options const &opt) {
+  constexpr std::array<std::string_view, 5> specialNames{"svr", "you", "fft",
+                                                         "dac", "out"};
+  // Large enough for the special nodes to get distinct positions
+  auto nbNodes = std::max(opt.size, size_t{12});
+  size_t nameLength{3};
+  for (size_t nbNames{26 * 26 * 26}; nbNames < nbNodes + specialNames.size();
+       nbNames *= 26) {
+    nameLength += 1;
+  }
+  std::vector<std::string> names{};
+  names.reserve(nbNodes);
+  for (size_t code{0}; names.size() < nbNodes; ++code) {
+    std::string name(nameLength, 'a');
+    for (auto value{code}; auto &c : name | std::views::reverse) {
+      c = static_cast<char>('a' + value % 26);
+      value /= 26;
+    }
+    if (!std::ranges::contains(specialNames, name))
+      names.push_back(std::move(name));
+  }
+  names[0] = specialNames[0];
+  names[nbNodes / 4] = specialNames[1];
+  names[nbNodes / 3] = specialNames[2];
+  names[2 * nbNodes / 3] = specialNames[3];
+  names.back() = specialNames[4];
+
+  auto window = std::max(opt.width, size_t{1});
+  std::vector<size_t> targets{};
+  for (size_t node{0}; node + 1 < nbNodes; ++node) {
+    targets.assign(1, node + 1);
+    for (auto nbEdges = rng.between(0, 3); nbEdges > 0; --nbEdges) {
+      auto target = std::min(nbNodes - 1, node + rng.between(1, window));
+      if (!std::ranges::contains(targets, target))
+        targets.push_back(target);
+    }
+    out << names[node] << ':';
+    for (auto target : targets)
+      out << ' ' << names[target];
+    out << '\n';
+  }
+}
+
+// Six random 3x3 presents, then size regions up to width on each side,
+// filled between 60% and 110%.
+void genDay12(Output &out, Random &rng, Options const &opt) {
+  constexpr size_t nbShapes{6};
+  std::array<size_t, nbShapes> shapeCells{};
+  for (size_t shape{0}; shape < nbShapes; ++shape) {
+    std::array<char, 9> cells{};
+    do {
+      std::ranges::generate(cells,
+                            [&] { return rng.chance(2, 3) ? '#' : '.'; });
+    } while (!std::ranges::contains(cells, '#'));
+    shapeCells[shape] = static_cast<size_t>(std::ranges::count(cells, '#'));
+    out << shape << ":\n";
+    for (size_t row{0}; row < 3; ++row)
+      out << std::string_view{cells.data() + 3 * row, 3} << '\n';
+    out << '\n';
+  }
+  auto maxSide = std::max(opt.width, size_t{3});
+  for (size_t i{0}; i < opt.size; ++i) {
+    auto width = rng.between(3, maxSide);
+    auto height = rng.between(3, maxSide);
+    auto target = width * height * rng.between(60, 110) / 100;
+    std::array<size_t, nbShapes> counts{};
+    for (size_t filled{0}; filled < target;) {
+      auto shape = rng.between(0, nbShapes - 1);
+      counts[shape] += 1;
+      filled += shapeCells[shape];
+    }
+    out << width << 'x' << height << ':';
+    for (auto count : counts)
+      out << ' ' << count;
+    out << '\n';
+  }
+}
+
+struct Generator {
+  std::string_view name;
+  std::string_view description;
+  size_t defaultSize;
+  size_t defaultWidth;
+  void (*generate)(Output &, Random &, Options const &);
+};
+
+constexpr std::array<Generator, 12> generators{{
+    {"day1", "size rotations of at most width clicks", 4'000, 999, genDay1},
+    {"day2", "size ID ranges, spanning at most width IDs", 40, 1'000'000,
+     genDay2},
+    {"day3", "size banks of width batteries", 200, 100, genDay3},
+    {"day4", "grid of size rows and width columns", 140, 140, genDay4},
+    {"day5", "size ranges and 5 * size IDs", 200, 0, genDay5},
+    {"day6", "size problems of width operands", 1'000, 4, genDay6},
+    {"day7", "size splitter rows, width columns", 70, 141, genDay7},
+    {"day8", "size boxes, coordinates below width", 1'000, 100'000, genDay8},
+    {"day9", "about size tiles, coordinates below width", 500, 100'000,
+     genDay9},
+    {"day10", "size machines", 200, 0, genDay10},
+    {"day11", "size devices, edges at most width nodes forward", 600, 20,
+     genDay11},
+    {"day12", "size regions, sides at most width", 1'000, 50, genDay12},
+}};
+
+int usage(std::string_view program) {
+  std::cerr << std::format("Usage: {} <day> [--size N] [--width N] "
+                           "[--seed N] [--output FILE]\n",
+                           program);
+  for (auto const &generator : generators) {
+    std::cerr << std::format("  {:<6} {} (default size {}, width {})\n",
+                             generator.name, generator.description,
+                             generator.defaultSize, generator.defaultWidth);
+  }
+  return 1;
+}
+} // namespace
+
+int main(int argc, char **argv) {
+  std::span args{argv, static_cast<size_t>(argc)};
+  if (args.size() < 2)
+    return usage(args[0]);
+  auto generator = std::ranges::find(generators, std::string_view{args[1]},
+                                     &Generator::name);
+  if (generator == generators.end())
+    return usage(args[0]);
+
+  Options options{generator->defaultSize, generator->defaultWidth};
+  uint64_t seed{2025};
+  char const *outputPath{nullptr};
+  try {
+    for (size_t i{2}; i + 1 < args.size(); i += 2) {
+      std::string_view option{args[i]};
+      if (option == "--size") {
+        options.size = std::stoull(args[i + 1]);
+      } else if (option == "--width") {
+        options.width = std::stoull(args[i + 1]);
+      } else if (option == "--seed") {
+        seed = std::stoull(args[i + 1]);
+      } else if (option == "--output") {
+        outputPath = args[i + 1];
+      } else {
+        return usage(args[0]);
+      }
+    }
+    int fd{STDOUT_FILENO};
+    if (outputPath != nullptr) {
+      fd = open(outputPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+      if (fd == -1)
+        throw std::system_error(errno, std::generic_category(), outputPath);
+    }
+    Output out{fd};
+    Random rng{seed};
+    generator->generate(out, rng, options);
+    out.flush();
+    if (outputPath != nullptr)
+      close(fd);
+  } catch (std::exception const &e) {
+    std::cerr << e.what() << '\n';
+    return 1;
+  }
+  return 0;
+}
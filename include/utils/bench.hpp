@@ -0,0 +1,210 @@
+#ifndef UTILS_BENCH_HPP
+#define UTILS_BENCH_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <format>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <ranges>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "utils/scan.hpp"
+
+// Minimal benchmark harness. Solvers compiled with AOC_BENCH register cases
+// and checks, and hand their main over to runAll().
+namespace utils::bench {
+// Builds the input for a given scale; scale 1 is the fixed puzzle example
+using InputMaker = std::function<std::string(size_t scale)>;
+// Solves the input, the result is printed so the work cannot be elided
+using Solver = std::function<uint64_t(std::string_view input)>;
+
+struct Case {
+  std::string name;
+  InputMaker makeInput;
+  Solver solve;
+  size_t maxScale;
+};
+
+inline std::vector<Case> &getCases() {
+  static std::vector<Case> cases{};
+  return cases;
+}
+
+struct Registration {
+  Registration(std::string name, InputMaker makeInput, Solver solve,
+               size_t maxScale = std::numeric_limits<size_t>::max()) {
+    getCases().emplace_back(std::move(name), std::move(makeInput),
+                            std::move(solve), maxScale);
+  }
+};
+
+// Run-time self-checks, for the SIMD kernels that static_asserts cannot
+// reach. They run before the cases, runAll fails on the first one false.
+struct Check {
+  std::string name;
+  std::function<bool()> check;
+};
+
+inline std::vector<Check> &getChecks() {
+  static std::vector<Check> checks{};
+  return checks;
+}
+
+struct CheckRegistration {
+  CheckRegistration(std::string name, std::function<bool()> check) {
+    getChecks().emplace_back(std::move(name), std::move(check));
+  }
+};
+
+// Lines of input, without the empty token after the final '\n'
+constexpr SplitView<'\n'> getLines(std::string_view input) {
+  if (input.ends_with('\n'))
+    input.remove_suffix(1);
+  return {input};
+}
+
+// The lines of example, nbTimes over
+inline std::string repeatLines(std::string_view example, size_t nbTimes) {
+  std::string res{};
+  res.reserve((example.size() + 1) * nbTimes);
+  for (size_t i{0}; i < nbTimes; ++i) {
+    res += example;
+    if (!example.ends_with('\n'))
+      res += '\n';
+  }
+  return res;
+}
+
+// Every line of example repeated nbTimes side by side, separated by separator
+inline std::string repeatColumns(std::string_view example, size_t nbTimes,
+                                 std::string_view separator = "") {
+  std::string res{};
+  for (auto line : getLines(example)) {
+    for (size_t i{0}; i < nbTimes; ++i) {
+      if (i != 0)
+        res += separator;
+      res += line;
+    }
+    res += '\n';
+  }
+  return res;
+}
+
+// About scale copies of a grid example, tiled in a square
+inline std::string tileGrid(std::string_view grid, size_t scale) {
+  auto side = std::max(
+      size_t{1},
+      static_cast<size_t>(std::lround(std::sqrt(static_cast<double>(scale)))));
+  return repeatLines(repeatColumns(grid, side), side);
+}
+
+struct Measure {
+  double median;
+  double mean;
+  double stddev;
+  double min;
+};
+
+// Seconds per call of fn over nbSamples samples. Short calls are batched so
+// that each sample lasts at least minSampleTime.
+inline Measure measure(auto &&fn, size_t nbSamples) {
+  using clock = std::chrono::steady_clock;
+  constexpr std::chrono::duration<double> minSampleTime{0.01};
+  auto timeBatch = [&fn](size_t batch) {
+    auto start = clock::now();
+    for (size_t i{0}; i < batch; ++i)
+      fn();
+    return std::chrono::duration<double>(clock::now() - start);
+  };
+  auto single = timeBatch(1);
+  size_t batch{1};
+  if (single < minSampleTime) {
+    batch = static_cast<size_t>(
+        std::ceil(minSampleTime / std::max(single, decltype(single){1e-9})));
+  }
+  std::vector<double> samples(nbSamples);
+  for (auto &sample : samples)
+    sample = timeBatch(batch).count() / static_cast<double>(batch);
+  std::ranges::sort(samples);
+  auto mean = std::reduce(begin(samples), end(samples)) /
+              static_cast<double>(nbSamples);
+  auto variance = std::transform_reduce(begin(samples), end(samples), 0.,
+                                        std::plus<>{}, [mean](double s) {
+                                          return (s - mean) * (s - mean);
+                                        }) /
+                  static_cast<double>(nbSamples);
+  return {samples[nbSamples / 2], mean, std::sqrt(variance), samples[0]};
+}
+
+// Options: --reps N (samples per measure), --scale N (repeatable),
+// --filter TEXT (only cases whose name contains TEXT)
+inline int runAll(int argc, char **argv) {
+  size_t nbSamples{10};
+  std::vector<size_t> scales{};
+  std::string_view filter{};
+  for (int i{1}; i + 1 < argc; i += 2) {
+    std::string_view option{argv[i]};
+    if (option == "--reps") {
+      nbSamples = std::max(1ul, std::stoul(argv[i + 1]));
+    } else if (option == "--scale") {
+      scales.push_back(std::stoul(argv[i + 1]));
+    } else if (option == "--filter") {
+      filter = argv[i + 1];
+    } else {
+      std::cerr << std::format("Unknown option {}\n", option);
+      return 1;
+    }
+  }
+  if (scales.empty())
+    scales = {1, 1000, 100000};
+
+  for (auto const &check : getChecks()) {
+    if (!check.name.contains(filter))
+      continue;
+    if (!check.check()) {
+      std::cerr << std::format("Check {} failed\n", check.name);
+      return 1;
+    }
+    std::cout << std::format("{:<28} check passed\n", check.name);
+  }
+
+  for (auto const &benchCase : getCases()) {
+    if (!benchCase.name.contains(filter))
+      continue;
+    for (auto scale : scales) {
+      if (scale > benchCase.maxScale)
+        continue;
+      auto input = benchCase.makeInput(scale);
+      auto nbLines = std::ranges::count(input, '\n');
+      uint64_t result{};
+      auto timing = measure(
+          [&] {
+            result = benchCase.solve(input);
+            // Keep the result alive across iterations
+            asm volatile("" : : "r"(result) : "memory");
+          },
+          nbSamples);
+      std::cout << std::format(
+          "{:<28} x{:<8} {:>10} B {:>9} lines  median {:>10.3e} s "
+          "(mean {:.3e} +- {:.1e}, min {:.3e})  {:>8.2f} MB/s  "
+          "{:>8.3f} Mlines/s  result {}\n",
+          benchCase.name, scale, input.size(), nbLines, timing.median,
+          timing.mean, timing.stddev, timing.min,
+          static_cast<double>(input.size()) / timing.median / 1e6,
+          static_cast<double>(nbLines) / timing.median / 1e6, result);
+    }
+  }
+  return 0;
+}
+} // namespace utils::bench
+
+#endif // UTILS_BENCH_HPP
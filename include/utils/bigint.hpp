@@ -0,0 +1,225 @@
+#ifndef UTILS_BIGINT_HPP
+#define UTILS_BIGINT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace utils {
+__extension__ typedef unsigned __int128 uint128;
+
+namespace detail {
+// Little-endian 32-bit limbs
+using Limbs = std::vector<uint32_t>;
+using LimbSpan = std::span<uint32_t const>;
+
+inline constexpr size_t karatsubaThreshold{32};
+
+constexpr void trim(Limbs &limbs) {
+  while (!limbs.empty() && limbs.back() == 0)
+    limbs.pop_back();
+}
+
+// target += source * 2^(32 * shift)
+constexpr void addShifted(Limbs &target, LimbSpan source, size_t shift) {
+  if (target.size() < source.size() + shift)
+    target.resize(source.size() + shift, 0);
+  uint64_t carry{0};
+  auto pos = shift;
+  for (auto limb : source) {
+    carry += uint64_t{target[pos]} + limb;
+    target[pos++] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+  for (; carry != 0; ++pos) {
+    if (pos == target.size())
+      target.push_back(0);
+    carry += target[pos];
+    target[pos] = static_cast<uint32_t>(carry);
+    carry >>= 32;
+  }
+}
+
+// target -= source, target being the largest
+constexpr void subtract(Limbs &target, LimbSpan source) {
+  uint64_t borrow{0};
+  for (size_t pos{0}; pos < target.size(); ++pos) {
+    if (pos >= source.size() && borrow == 0)
+      break;
+    auto subtracted = (pos < source.size() ? source[pos] : 0) + borrow;
+    borrow = target[pos] < subtracted;
+    target[pos] = static_cast<uint32_t>(target[pos] - subtracted);
+  }
+  trim(target);
+}
+
+constexpr Limbs multiplySchoolbook(LimbSpan a, LimbSpan b) {
+  Limbs res(a.size() + b.size(), 0);
+  for (size_t i{0}; i < a.size(); ++i) {
+    uint64_t carry{0};
+    for (size_t j{0}; j < b.size(); ++j) {
+      carry += uint64_t{a[i]} * b[j] + res[i + j];
+      res[i + j] = static_cast<uint32_t>(carry);
+      carry >>= 32;
+    }
+    res[i + b.size()] = static_cast<uint32_t>(carry);
+  }
+  trim(res);
+  return res;
+}
+
+// Karatsuba: with x = x1 * B + x0, a * b = z2 * B^2 + z1 * B + z0 where
+// z1 = (a0 + a1)(b0 + b1) - z0 - z2, three half-size products instead of four
+constexpr Limbs multiply(LimbSpan a, LimbSpan b) {
+  if (std::min(a.size(), b.size()) < karatsubaThreshold)
+    return multiplySchoolbook(a, b);
+  auto half = std::max(a.size(), b.size()) / 2;
+  auto low = [half](LimbSpan x) { return x.first(std::min(half, x.size())); };
+  auto high = [half](LimbSpan x) {
+    return x.size() > half ? x.subspan(half) : LimbSpan{};
+  };
+  auto z0 = multiply(low(a), low(b));
+  auto z2 = multiply(high(a), high(b));
+  Limbs aSum(low(a).begin(), low(a).end());
+  addShifted(aSum, high(a), 0);
+  Limbs bSum(low(b).begin(), low(b).end());
+  addShifted(bSum, high(b), 0);
+  trim(aSum);
+  trim(bSum);
+  auto z1 = multiply(aSum, bSum);
+  subtract(z1, z0);
+  subtract(z1, z2);
+  auto res = std::move(z0);
+  addShifted(res, z1, half);
+  addShifted(res, z2, 2 * half);
+  trim(res);
+  return res;
+}
+} // namespace detail
+
+// Arbitrary-precision unsigned integer, for the few values that outgrow
+// 128 bits
+class BigUnsigned {
+public:
+  constexpr BigUnsigned() = default;
+  constexpr BigUnsigned(uint128 value) {
+    for (; value != 0; value >>= 32)
+      limbs.push_back(static_cast<uint32_t>(value));
+  }
+
+  constexpr bool operator==(BigUnsigned const &) const = default;
+
+  constexpr BigUnsigned &operator+=(BigUnsigned const &other) {
+    detail::addShifted(limbs, other.limbs, 0);
+    return *this;
+  }
+
+  friend constexpr BigUnsigned operator+(BigUnsigned a,
+                                         BigUnsigned const &b) {
+    a += b;
+    return a;
+  }
+
+  friend constexpr BigUnsigned operator*(BigUnsigned const &a,
+                                         BigUnsigned const &b) {
+    BigUnsigned res{};
+    res.limbs = detail::multiply(a.limbs, b.limbs);
+    return res;
+  }
+
+  // Product of values as a balanced tree, so that the large multiplications
+  // are between operands of similar sizes, where Karatsuba pays off
+  static constexpr BigUnsigned product(std::span<uint64_t const> values) {
+    if (values.empty())
+      return BigUnsigned{1};
+    if (values.size() == 1)
+      return BigUnsigned{values[0]};
+    auto half = values.size() / 2;
+    return product(values.first(half)) * product(values.subspan(half));
+  }
+
+  // Value modulo 2^64
+  constexpr uint64_t getLowBits() const {
+    uint64_t res{0};
+    for (size_t i{0}; i < std::min(limbs.size(), size_t{2}); ++i)
+      res |= uint64_t{limbs[i]} << (32 * i);
+    return res;
+  }
+
+  // Value modulo 2^128
+  constexpr uint128 getLowBits128() const {
+    uint128 res{0};
+    for (size_t i{0}; i < std::min(limbs.size(), size_t{4}); ++i)
+      res |= uint128{limbs[i]} << (32 * i);
+    return res;
+  }
+
+  // Number of significant bits, 0 for zero
+  constexpr size_t getBitWidth() const {
+    if (limbs.empty())
+      return 0;
+    return 32 * limbs.size() -
+           static_cast<size_t>(std::countl_zero(limbs.back()));
+  }
+
+  constexpr std::string toDecimal() const {
+    if (limbs.empty())
+      return "0";
+    constexpr uint64_t chunk{1'000'000'000};
+    std::string res{};
+    auto rest = limbs;
+    while (!rest.empty()) {
+      // rest /= 10^9, the remainder gives 9 digits
+      uint64_t remainder{0};
+      for (auto limb = rest.rbegin(); limb != rest.rend(); ++limb) {
+        auto current = (remainder << 32) | *limb;
+        *limb = static_cast<uint32_t>(current / chunk);
+        remainder = current % chunk;
+      }
+      detail::trim(rest);
+      for (size_t i{0}; i < 9 && (!rest.empty() || remainder != 0); ++i) {
+        res.push_back(static_cast<char>('0' + remainder % 10));
+        remainder /= 10;
+      }
+    }
+    std::ranges::reverse(res);
+    return res;
+  }
+
+private:
+  detail::Limbs limbs{};
+};
+
+namespace detail {
+constexpr bool checkBigUnsigned() {
+  // 2^64 * 2^64 = 2^128
+  BigUnsigned twoTo64{uint128{1} << 64};
+  if ((twoTo64 * twoTo64).toDecimal() !=
+      "340282366920938463463374607431768211456")
+    return false;
+  // Tree product with Karatsuba steps against a chain of small products
+  std::vector<uint64_t> values{};
+  BigUnsigned chained{1};
+  for (uint64_t i{1}; i <= 40; ++i) {
+    values.push_back(i * 0x9E3779B97F4A7C15);
+    chained = chained * BigUnsigned{values.back()};
+  }
+  auto twoTo128 = twoTo64 * twoTo64;
+  if (twoTo128.getBitWidth() != 129 || twoTo128.getLowBits128() != 0 ||
+      (twoTo128 + BigUnsigned{5}).getLowBits128() != 5 ||
+      BigUnsigned{}.getBitWidth() != 0)
+    return false;
+  return BigUnsigned::product(values) == chained &&
+         (chained + BigUnsigned{7}).getLowBits() ==
+             chained.getLowBits() + 7 &&
+         BigUnsigned{1234567890123456789}.toDecimal() == "1234567890123456789";
+}
+static_assert(checkBigUnsigned());
+} // namespace detail
+} // namespace utils
+
+#endif // UTILS_BIGINT_HPP
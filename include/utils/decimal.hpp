@@ -3,7 +3,12 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <concepts>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
 
 namespace utils {
 template <std::integral T> constexpr T getDecimalDigits(T value) {
@@ -38,6 +43,91 @@ inline constexpr T addLowDigit(T &&value, char digit) {
 }
 
 static_assert(addLowDigit(0u, '7') == 7u);
+
+// Decimal representation of value, for the unsigned types iostreams cannot
+// print such as unsigned __int128
+template <typename T> constexpr std::string toDecimal(T value) {
+  std::string result{};
+  do {
+    result.insert(result.begin(), static_cast<char>('0' + value % 10));
+    value /= 10;
+  } while (value != 0);
+  return result;
+}
+
+static_assert(toDecimal(0u) == "0");
+static_assert(toDecimal(1234567u) == "1234567");
+
+// Adds the decimal number digits to the one in sum, both without leading
+// zeros, for values of any length
+constexpr void addDecimal(std::string &sum, std::string_view digits) {
+  if (sum.size() < digits.size())
+    sum.insert(0, digits.size() - sum.size(), '0');
+  int carry{0};
+  auto pos = sum.size();
+  for (auto digit = digits.rbegin(); pos > 0; --pos) {
+    int value = sum[pos - 1] - '0' + carry;
+    if (digit != digits.rend())
+      value += *digit++ - '0';
+    else if (carry == 0)
+      break;
+    carry = value / 10;
+    sum[pos - 1] = static_cast<char>('0' + value % 10);
+  }
+  if (carry != 0)
+    sum.insert(sum.begin(), '1');
+}
+
+namespace detail {
+constexpr bool checkAddDecimal() {
+  std::string sum{"0"};
+  addDecimal(sum, "999");
+  addDecimal(sum, "1");
+  addDecimal(sum, "12");
+  addDecimal(sum, "98988");
+  return sum == "100000";
+}
+static_assert(checkAddDecimal());
+} // namespace detail
+
+// SWAR helpers on 8 characters loaded little-endian in a 64-bit word
+// (first character in the lowest byte).
+
+// Number of leading characters of chunk that are decimal digits
+constexpr unsigned countLeadingDigits(uint64_t chunk) {
+  constexpr uint64_t ones{0x0101010101010101};
+  auto offset = chunk ^ (ones * '0');
+  // High bit of a byte is set iff the byte is not in '0'..'9'
+  auto notDigit = (((offset & (ones * 0x7F)) + ones * 0x76) | offset) &
+                  (ones * 0x80);
+  return static_cast<unsigned>(std::countr_zero(notDigit)) / 8;
+}
+
+// Value of the 8 decimal digits of chunk
+constexpr uint32_t parseEightDigits(uint64_t chunk) {
+  constexpr uint64_t ones{0x0101010101010101};
+  chunk -= ones * '0';
+  chunk = chunk * 10 + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FF) * (100 + (1000000ull << 32))) +
+           (((chunk >> 16) & 0x000000FF000000FF) * (1 + (10000ull << 32)))) >>
+          32;
+  return static_cast<uint32_t>(chunk);
+}
+
+// Value of the first nbDigits (1 to 8) digits of chunk
+constexpr uint32_t parseLeadingDigits(uint64_t chunk, unsigned nbDigits) {
+  constexpr uint64_t zeros{0x3030303030303030};
+  auto shift = 8 * (8 - nbDigits);
+  if (shift == 0)
+    return parseEightDigits(chunk);
+  return parseEightDigits((chunk << shift) | (zeros >> (64 - shift)));
+}
+
+static_assert(countLeadingDigits(0x3938373635343332) == 8);
+static_assert(countLeadingDigits(0x393837363534202D) == 0);
+static_assert(countLeadingDigits(0x3938373635342D32) == 1);
+static_assert(parseEightDigits(0x3837363534333231) == 12345678);
+static_assert(parseLeadingDigits(0x3837362D34333231, 4) == 1234);
 } // namespace utils
 
 #endif // UTILS_DECIMAL_HPP
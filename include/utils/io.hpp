@@ -1,17 +1,157 @@
 #ifndef UTILS_IO_HPP
 #define UTILS_IO_HPP
 
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
 #include <generator>
-#include <iostream>
-#include <string>
+#include <optional>
 #include <string_view>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+#include "utils/scan.hpp"
 
 namespace utils {
-inline std::generator<std::string_view> getLines() {
-  std::string value{};
-  while (std::getline(std::cin, value)) {
-    co_yield value;
+// Line source over a file descriptor.
+// Regular files are memory-mapped and lines are views into the mapping.
+// Pipes and terminals are read through a large buffer refilled in place, so
+// a line stays valid only until the next one is requested (as with getline).
+class MappedInput {
+public:
+  static constexpr size_t readChunk{size_t{1} << 20};
+
+  explicit MappedInput(int fd, bool owned = false) : fd(fd), owned(owned) {
+    struct stat sb;
+    if (fstat(fd, &sb) == -1)
+      throw std::system_error(errno, std::generic_category(), "fstat");
+    // Some special files (procfs, ...) are regular but report a null size
+    if (!S_ISREG(sb.st_mode) || sb.st_size == 0)
+      return;
+    mappedSize = static_cast<size_t>(sb.st_size);
+    void *addr = mmap(nullptr, mappedSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED)
+      throw std::system_error(errno, std::generic_category(), "mmap");
+    madvise(addr, mappedSize, MADV_SEQUENTIAL);
+    mapping = static_cast<char const *>(addr);
+    // Honour an already advanced descriptor (e.g. partially consumed stdin)
+    auto offset = lseek(fd, 0, SEEK_CUR);
+    head = mapping + std::min(mappedSize, static_cast<size_t>(
+                                              std::max(offset, off_t{0})));
+    tail = mapping + mappedSize;
+  }
+
+  explicit MappedInput(char const *path)
+      : MappedInput(openOrThrow(path), true) {}
+
+  MappedInput(MappedInput const &) = delete;
+  MappedInput &operator=(MappedInput const &) = delete;
+
+  ~MappedInput() {
+    if (mapping != nullptr)
+      munmap(const_cast<char *>(mapping), mappedSize);
+    if (owned)
+      close(fd);
   }
+
+  // Reader shared by every consumer of standard input, so that successive
+  // getLines() calls resume where the previous one stopped.
+  static MappedInput &standardInput() {
+    static MappedInput input{STDIN_FILENO};
+    return input;
+  }
+
+  bool isMapped() const { return mapping != nullptr; }
+
+  std::optional<std::string_view> nextLine() {
+    if (!isMapped())
+      refillUntilNewline();
+    if (head == tail)
+      return std::nullopt;
+    std::string_view available{head, tail};
+    auto eol =
+        std::min(findFirstOf<'\n'>(available, scanned), available.size());
+    std::string_view res{available.substr(0, eol)};
+    head += std::min(eol + 1, available.size());
+    scanned = 0;
+    return res;
+  }
+
+  // Everything not consumed yet, as one contiguous view.
+  std::string_view readAll() {
+    if (!isMapped()) {
+      while (!eof)
+        fill();
+    }
+    std::string_view res{head, tail};
+    head = tail;
+    scanned = 0;
+    return res;
+  }
+
+  std::generator<std::string_view> lines() {
+    while (auto line = nextLine())
+      co_yield *line;
+  }
+
+private:
+  static int openOrThrow(char const *path) {
+    int res = open(path, O_RDONLY);
+    if (res == -1)
+      throw std::system_error(errno, std::generic_category(), path);
+    return res;
+  }
+
+  // Streaming mode only: make sure [head, tail) holds a full line or the end
+  // of the input. scanned remembers how much was already searched.
+  void refillUntilNewline() {
+    while (!eof) {
+      std::string_view available{head, tail};
+      if (findFirstOf<'\n'>(available, scanned) != std::string_view::npos)
+        return;
+      scanned = available.size();
+      fill();
+    }
+  }
+
+  void fill() {
+    size_t available = static_cast<size_t>(tail - head);
+    size_t offset = static_cast<size_t>(head - buffer.data());
+    if (offset != 0) {
+      std::memmove(buffer.data(), head, available);
+    }
+    if (buffer.size() - available < readChunk) {
+      buffer.resize(std::max(buffer.size() * 2, available + readChunk));
+    }
+    ssize_t nbRead;
+    do {
+      nbRead = read(fd, buffer.data() + available, buffer.size() - available);
+    } while (nbRead == -1 && errno == EINTR);
+    if (nbRead == -1)
+      throw std::system_error(errno, std::generic_category(), "read");
+    eof = nbRead == 0;
+    head = buffer.data();
+    tail = head + available + static_cast<size_t>(nbRead);
+  }
+
+  int fd;
+  bool owned;
+  bool eof{false};
+  char const *mapping{nullptr};
+  size_t mappedSize{0};
+  char const *head{nullptr};
+  char const *tail{nullptr};
+  size_t scanned{0};
+  std::vector<char> buffer{};
+};
+
+inline std::generator<std::string_view> getLines() {
+  return MappedInput::standardInput().lines();
 }
 } // namespace utils
 
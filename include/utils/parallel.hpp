@@ -0,0 +1,182 @@
+#ifndef UTILS_PARALLEL_HPP
+#define UTILS_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "utils/scan.hpp"
+#include "utils/sort.hpp"
+
+namespace utils {
+inline size_t getNbThreads() {
+  return std::max(size_t{1}, size_t{std::thread::hardware_concurrency()});
+}
+
+// Cuts input into at most nbChunks pieces of similar size. Every piece but
+// the last ends right after a Delim, so no record straddles two pieces.
+template <char Delim = '\n'>
+constexpr std::vector<std::string_view> splitChunks(std::string_view input,
+                                                    size_t nbChunks) {
+  std::vector<std::string_view> res{};
+  nbChunks = std::max(nbChunks, size_t{1});
+  size_t targetSize = (input.size() + nbChunks - 1) / nbChunks;
+  size_t start{0};
+  while (start < input.size()) {
+    auto lastByte = std::min(start + targetSize, input.size()) - 1;
+    auto cut = findFirstOf<Delim>(input, lastByte);
+    auto end = cut == std::string_view::npos ? input.size() : cut + 1;
+    res.push_back(input.substr(start, end - start));
+    start = end;
+  }
+  return res;
+}
+
+// Sorts values on up to nbThreads threads: every chunk is radix sorted on
+// its own thread, then sorted runs are merged pairwise, in parallel, until
+// one is left. Stable like radixSort.
+template <typename T, typename Key = std::identity>
+void parallelSort(std::vector<T> &values, size_t nbThreads, Key key = {}) {
+  constexpr size_t minChunk{size_t{1} << 14};
+  nbThreads = std::clamp(values.size() / minChunk, size_t{1}, nbThreads);
+  std::vector<size_t> bounds{};
+  for (size_t i{0}; i <= nbThreads; ++i)
+    bounds.push_back(i * values.size() / nbThreads);
+  {
+    std::vector<std::jthread> workers{};
+    for (size_t i{0}; i < nbThreads; ++i) {
+      workers.emplace_back([&values, &bounds, &key, i] {
+        auto chunk = std::span{values}.subspan(bounds[i],
+                                               bounds[i + 1] - bounds[i]);
+        radixSort(chunk, key);
+      });
+    }
+  }
+  std::vector<T> buffer(values.size());
+  auto less = [&key](T const &a, T const &b) { return key(a) < key(b); };
+  while (bounds.size() > 2) {
+    std::vector<size_t> nextBounds{0};
+    {
+      std::vector<std::jthread> workers{};
+      for (size_t i{0}; i + 1 < bounds.size(); i += 2) {
+        auto begin = bounds[i];
+        auto middle = bounds[i + 1];
+        auto end = i + 2 < bounds.size() ? bounds[i + 2] : middle;
+        workers.emplace_back([&values, &buffer, &less, begin, middle, end] {
+          std::merge(values.begin() + begin, values.begin() + middle,
+                     values.begin() + middle, values.begin() + end,
+                     buffer.begin() + begin, less);
+        });
+        nextBounds.push_back(end);
+      }
+    }
+    std::swap(values, buffer);
+    bounds = std::move(nextBounds);
+  }
+}
+
+namespace detail {
+// Chunk indices left to a worker. Both bounds share one atomic word, begin
+// in the low half, so that the owner taking from the front and thieves
+// taking from the back agree on the last chunk.
+class StealableRange {
+public:
+  void reset(uint32_t begin, uint32_t end) { bounds.store(pack(begin, end)); }
+
+  std::optional<size_t> popFront() {
+    auto current = bounds.load();
+    while (true) {
+      auto [begin, end] = unpack(current);
+      if (begin >= end)
+        return std::nullopt;
+      if (bounds.compare_exchange_weak(current, pack(begin + 1, end)))
+        return begin;
+    }
+  }
+
+  std::optional<size_t> stealBack() {
+    auto current = bounds.load();
+    while (true) {
+      auto [begin, end] = unpack(current);
+      if (begin >= end)
+        return std::nullopt;
+      if (bounds.compare_exchange_weak(current, pack(begin, end - 1)))
+        return end - 1;
+    }
+  }
+
+private:
+  static constexpr uint64_t pack(uint32_t begin, uint32_t end) {
+    return (uint64_t{end} << 32) | begin;
+  }
+  static constexpr std::pair<uint32_t, uint32_t> unpack(uint64_t value) {
+    return {static_cast<uint32_t>(value), static_cast<uint32_t>(value >> 32)};
+  }
+
+  std::atomic<uint64_t> bounds{0};
+};
+} // namespace detail
+
+// Parallel fold_left(lines | transform(fn), init, op) over the lines of
+// input, for an associative op of identity init. The input is cut at line
+// boundaries into many chunks of similar size, dealt in contiguous runs to
+// nbThreads workers; a worker out of chunks steals from the back of the
+// others' runs, so that costly parts of the input are shared out. Chunks are
+// folded on their own, then together in input order.
+template <typename T, typename Op, typename Fn>
+T foldLinesParallel(std::string_view input, size_t nbThreads, T init, Op op,
+                    Fn fn) {
+  constexpr size_t chunksPerThread{16};
+  nbThreads = std::max(nbThreads, size_t{1});
+  auto chunks = splitChunks(input, nbThreads * chunksPerThread);
+  std::vector<T> partials(chunks.size(), init);
+  std::vector<detail::StealableRange> queues(nbThreads);
+  for (size_t i{0}; i < nbThreads; ++i) {
+    queues[i].reset(static_cast<uint32_t>(i * chunks.size() / nbThreads),
+                    static_cast<uint32_t>((i + 1) * chunks.size() / nbThreads));
+  }
+  auto foldChunk = [&](size_t idx) {
+    auto chunk = chunks[idx];
+    auto acc = init;
+    while (!chunk.empty()) {
+      auto eol = std::min(findFirstOf<'\n'>(chunk), chunk.size());
+      acc = op(std::move(acc), fn(chunk.substr(0, eol)));
+      chunk.remove_prefix(std::min(eol + 1, chunk.size()));
+    }
+    partials[idx] = std::move(acc);
+  };
+  {
+    std::vector<std::jthread> workers{};
+    for (size_t i{0}; i < nbThreads; ++i) {
+      workers.emplace_back([&, i] {
+        while (auto idx = queues[i].popFront())
+          foldChunk(*idx);
+        for (size_t offset{1}; offset < nbThreads; ++offset) {
+          auto &victim = queues[(i + offset) % nbThreads];
+          while (auto idx = victim.stealBack())
+            foldChunk(*idx);
+        }
+      });
+    }
+  }
+  for (auto &partial : partials)
+    init = op(std::move(init), std::move(partial));
+  return init;
+}
+
+static_assert(splitChunks("a\nb\nc\nd\n", 2) ==
+              std::vector<std::string_view>{"a\nb\n", "c\nd\n"});
+static_assert(splitChunks("aaaa\nb", 4) ==
+              std::vector<std::string_view>{"aaaa\n", "b"});
+static_assert(splitChunks("", 4).empty());
+} // namespace utils
+
+#endif // UTILS_PARALLEL_HPP
@@ -2,27 +2,74 @@
 #define UTILS_PARSER_HPP
 
 #include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
-#include <ranges>
+#include <cstring>
+#include <initializer_list>
+#include <span>
 #include <string_view>
 
+#include "utils/decimal.hpp"
+#include "utils/scan.hpp"
+
 namespace utils {
 class Parser {
 public:
   constexpr Parser(std::string_view input) : data(input) {};
   constexpr uint_fast32_t getUnsignedInt() {
-    uint_fast32_t result{0};
+    return getUnsigned<uint_fast32_t>();
+  }
+
+  // Parses the leading run of digits, 8 at a time when not in a constant
+  // expression. The value wraps if T is too small for it.
+  template <std::unsigned_integral T> constexpr T getUnsigned() {
+    static constexpr auto powers = powersOfTen<uint64_t>();
+    T result{0};
     size_t index{0};
-    for (auto const c : data | std::views::take_while([](char c) {
-                          return c >= '0' && c <= '9';
-                        })) {
-      result = result * 10 + static_cast<uint_fast32_t>(c - '0');
+    if !consteval {
+      if constexpr (std::endian::native == std::endian::little) {
+        while (index + 8 <= data.size()) {
+          uint64_t chunk;
+          std::memcpy(&chunk, data.data() + index, sizeof(chunk));
+          auto nbDigits = countLeadingDigits(chunk);
+          if (nbDigits == 0)
+            break;
+          result = static_cast<T>(result * powers[nbDigits] +
+                                  parseLeadingDigits(chunk, nbDigits));
+          index += nbDigits;
+          if (nbDigits < 8) {
+            data = data.substr(index);
+            return result;
+          }
+        }
+      }
+    }
+    while (index < data.size() && data[index] >= '0' && data[index] <= '9') {
+      addLowDigit(result, data[index]);
       index += 1;
     }
     data = data.substr(index);
     return result;
   }
+
+  // Fills out with the next numbers, skipping whatever separates them.
+  // Returns how many were parsed.
+  constexpr size_t parseUnsignedInts(std::span<uint64_t> out) {
+    size_t nbParsed{0};
+    while (nbParsed < out.size()) {
+      auto firstDigit = std::ranges::find_if(
+          data, [](char c) { return c >= '0' && c <= '9'; });
+      drop(static_cast<size_t>(firstDigit - data.begin()));
+      if (data.empty())
+        break;
+      out[nbParsed++] = getUnsigned<uint64_t>();
+    }
+    return nbParsed;
+  }
+
   constexpr std::string_view drop(size_t n) {
     auto result = data.substr(0, std::min(n, data.size()));
     data = data.substr(std::min(n, data.size()));
@@ -38,6 +85,10 @@ public:
     drop(res);
     return res;
   }
+  // Consumes and returns everything before the first of Delims
+  template <char... Delims> constexpr std::string_view takeUntil() {
+    return drop(findFirstOf<Delims...>(data));
+  }
   constexpr bool empty() const { return data.empty(); }
 
   constexpr auto remain() const { return data; }
@@ -45,6 +96,22 @@ public:
 private:
   std::string_view data;
 };
+
+namespace detail {
+constexpr bool checkParseUnsignedInts(std::string_view input,
+                                      std::initializer_list<uint64_t> values) {
+  std::array<uint64_t, 4> out{};
+  Parser p{input};
+  auto nb = p.parseUnsignedInts(out);
+  return std::ranges::equal(std::span{out}.first(nb), values);
+}
+static_assert(checkParseUnsignedInts("3-5", {3, 5}));
+static_assert(checkParseUnsignedInts("162,817,812\n", {162, 817, 812}));
+static_assert(checkParseUnsignedInts(" 12345678901234567890 x",
+                                     {12345678901234567890u}));
+static_assert(checkParseUnsignedInts("1 2 3 4 5", {1, 2, 3, 4}));
+static_assert(Parser{"4294967296"}.getUnsigned<uint64_t>() == 4294967296);
+} // namespace detail
 } // namespace utils
 
 #endif // UTILS_PARSER_HPP
@@ -0,0 +1,63 @@
+#ifndef UTILS_RANDOM_HPP
+#define UTILS_RANDOM_HPP
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace utils {
+// xoshiro256** seeded through splitmix64. Unlike the std engines paired with
+// std distributions, the sequence is the same on every standard library, and
+// it can run in constant expressions.
+class Random {
+public:
+  constexpr explicit Random(uint64_t seed) {
+    for (auto &word : state) {
+      seed += 0x9E3779B97F4A7C15;
+      auto z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  constexpr uint64_t operator()() {
+    auto res = std::rotl(state[1] * 5, 7) * 9;
+    auto t = state[1] << 17;
+    state[2] ^= state[0];
+    state[3] ^= state[1];
+    state[1] ^= state[2];
+    state[0] ^= state[3];
+    state[2] ^= t;
+    state[3] = std::rotl(state[3], 45);
+    return res;
+  }
+
+  // Uniform in [lo, hi], without modulo bias
+  constexpr uint64_t between(uint64_t lo, uint64_t hi) {
+    auto range = hi - lo + 1;
+    if (range == 0)
+      return (*this)();
+    auto threshold = (0 - range) % range;
+    uint64_t draw;
+    do {
+      draw = (*this)();
+    } while (draw < threshold);
+    return lo + draw % range;
+  }
+
+  // True with probability num / den
+  constexpr bool chance(uint64_t num, uint64_t den) {
+    return between(0, den - 1) < num;
+  }
+
+private:
+  std::array<uint64_t, 4> state{};
+};
+
+static_assert(Random{42}() == Random{42}());
+static_assert(Random{1}.between(3, 3) == 3);
+static_assert(Random{7}.between(10, 19) - 10 < 10);
+} // namespace utils
+
+#endif // UTILS_RANDOM_HPP
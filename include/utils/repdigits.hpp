@@ -0,0 +1,175 @@
+#ifndef UTILS_REPDIGITS_HPP
+#define UTILS_REPDIGITS_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace utils {
+namespace detail {
+// Distinct prime factors of a value, values below 9699690 have at most 7
+struct PrimeFactors {
+  std::array<unsigned, 8> values{};
+  size_t size{0};
+};
+
+constexpr PrimeFactors getPrimeFactors(unsigned value) {
+  PrimeFactors result{};
+  for (unsigned divisor{2}; value > 1; ++divisor) {
+    if (value % divisor != 0)
+      continue;
+    result.values[result.size++] = divisor;
+    while (value % divisor == 0)
+      value /= divisor;
+  }
+  return result;
+}
+} // namespace detail
+
+// Compile-time tables on the values of type T written in base Base whose
+// digits repeat a pattern, indexed by width (number of digits) and pattern
+// width. T may be any unsigned type, unsigned __int128 included.
+template <typename T, unsigned Base = 10> struct RepDigits {
+  static_assert(Base >= 2);
+
+  // Number of digits of the largest T
+  static constexpr unsigned maxWidth = [] {
+    unsigned result{0};
+    for (auto value = static_cast<T>(~T{0}); value != 0; value /= Base)
+      result += 1;
+    return result;
+  }();
+
+  // Base to the power of each width that fits in a T
+  static constexpr auto powers = [] {
+    std::array<T, maxWidth> result{};
+    T power{1};
+    for (auto &value : result) {
+      value = power;
+      power *= Base;
+    }
+    return result;
+  }();
+
+  // Largest T of each width, Base^width - 1 unless it does not fit
+  static constexpr auto allNines = [] {
+    std::array<T, maxWidth + 1> result{};
+    for (unsigned width{1}; width < maxWidth; ++width)
+      result[width] = powers[width] - 1;
+    result[maxWidth] = static_cast<T>(~T{0});
+    return result;
+  }();
+
+  // seeds[width][patternWidth] turns a pattern into its repetition over
+  // width digits, patterns being repeated from the low digits
+  static constexpr auto seeds = [] {
+    std::array<std::array<T, maxWidth + 1>, maxWidth + 1> result{};
+    for (unsigned width{1}; width <= maxWidth; ++width)
+      for (unsigned patternWidth{1}; patternWidth <= width; ++patternWidth)
+        for (unsigned i{0}; i < width; i += patternWidth)
+          result[width][patternWidth] += powers[i];
+    return result;
+  }();
+
+  // Repunit of each width, the seed of one-digit patterns
+  static constexpr auto allOnes = [] {
+    std::array<T, maxWidth + 1> result{};
+    for (unsigned width{0}; width <= maxWidth; ++width)
+      result[width] = seeds[width][1];
+    return result;
+  }();
+
+  static constexpr auto primeFactors = [] {
+    std::array<detail::PrimeFactors, maxWidth + 1> result{};
+    for (unsigned width{0}; width <= maxWidth; ++width)
+      result[width] = detail::getPrimeFactors(width);
+    return result;
+  }();
+
+  // Term of the inclusion–exclusion over the periods of a width: one per
+  // squarefree divisor d > 1 of the width, with pattern width width / d,
+  // added when d has an odd number of prime factors (-mu(d) = 1)
+  struct PeriodTerm {
+    unsigned patternWidth;
+    bool isAdded;
+  };
+
+  static constexpr size_t maxTerms = [] {
+    size_t maxPrimes{0};
+    for (auto const &factors : primeFactors)
+      maxPrimes = std::max(maxPrimes, factors.size);
+    return (size_t{1} << maxPrimes) - 1;
+  }();
+
+  static constexpr auto periodTerms = [] {
+    struct Terms {
+      std::array<PeriodTerm, maxTerms> values{};
+      size_t size{0};
+    };
+    std::array<Terms, maxWidth + 1> result{};
+    for (unsigned width{1}; width <= maxWidth; ++width) {
+      auto const &primes = primeFactors[width];
+      for (unsigned subset{1}; subset < (1u << primes.size); ++subset) {
+        unsigned divisor{1};
+        for (size_t i{0}; i < primes.size; ++i)
+          if ((subset >> i) & 1)
+            divisor *= primes.values[i];
+        result[width].values[result[width].size++] = {
+            width / divisor, std::popcount(subset) % 2 == 1};
+      }
+    }
+    return result;
+  }();
+
+  // Number of digits of value
+  static constexpr unsigned getWidth(T value) {
+    if (value == 0)
+      return 1;
+    return static_cast<unsigned>(std::ranges::upper_bound(powers, value) -
+                                 powers.begin());
+  }
+
+  static constexpr std::span<unsigned const> getPrimeDivisors(unsigned width) {
+    auto const &factors = primeFactors[width];
+    return std::span{factors.values}.first(factors.size);
+  }
+
+  static constexpr std::span<PeriodTerm const>
+  getPeriodTerms(unsigned width) {
+    auto const &terms = periodTerms[width];
+    return std::span{terms.values}.first(terms.size);
+  }
+};
+
+namespace detail {
+using DecimalDigits = RepDigits<uint64_t>;
+static_assert(DecimalDigits::maxWidth == 20);
+static_assert(DecimalDigits::getWidth(0) == 1);
+static_assert(DecimalDigits::getWidth(9) == 1);
+static_assert(DecimalDigits::getWidth(10) == 2);
+static_assert(DecimalDigits::getWidth(~uint64_t{0}) == 20);
+static_assert(DecimalDigits::seeds[9][3] == 1001001);
+static_assert(DecimalDigits::seeds[14][7] == 10000001);
+static_assert(DecimalDigits::allOnes[4] == 1111);
+static_assert(DecimalDigits::allNines[4] == 9999);
+static_assert(DecimalDigits::allNines[20] == ~uint64_t{0});
+static_assert(std::ranges::equal(DecimalDigits::getPrimeDivisors(12),
+                                 std::array{2u, 3u}));
+static_assert(DecimalDigits::getPrimeDivisors(1).empty());
+static_assert(RepDigits<uint64_t, 2>::seeds[4][2] == 0b101);
+
+// 6 digits: periods 3 and 2 added, period 1 counted twice hence removed
+constexpr bool checkPeriodTerms() {
+  auto terms = DecimalDigits::getPeriodTerms(6);
+  return terms.size() == 3 && terms[0].patternWidth == 3 &&
+         terms[0].isAdded && terms[1].patternWidth == 2 && terms[1].isAdded &&
+         terms[2].patternWidth == 1 && !terms[2].isAdded;
+}
+static_assert(checkPeriodTerms());
+} // namespace detail
+} // namespace utils
+
+#endif // UTILS_REPDIGITS_HPP
@@ -0,0 +1,187 @@
+#ifndef UTILS_SCAN_HPP
+#define UTILS_SCAN_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <ranges>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace utils {
+// Delimiter scanning over raw buffers, 64 bytes at a time.
+// Bit i of a block mask is set when block[i] is one of the delimiters.
+
+inline constexpr size_t scanBlockSize{64};
+
+namespace detail {
+template <char... Delims>
+constexpr uint64_t matchMaskScalar(char const *block, size_t size) {
+  uint64_t res{0};
+  for (size_t i{0}; i < size; ++i) {
+    char c = block[i];
+    if (((c == Delims) || ...))
+      res |= uint64_t{1} << i;
+  }
+  return res;
+}
+
+#if defined(__AVX2__)
+template <char... Delims> inline uint64_t matchMaskSimd(char const *block) {
+  auto lo = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block));
+  auto hi = _mm256_loadu_si256(reinterpret_cast<__m256i const *>(block + 32));
+  auto matchLo = _mm256_setzero_si256();
+  auto matchHi = _mm256_setzero_si256();
+  ((matchLo = _mm256_or_si256(
+        matchLo, _mm256_cmpeq_epi8(lo, _mm256_set1_epi8(Delims))),
+    matchHi = _mm256_or_si256(
+        matchHi, _mm256_cmpeq_epi8(hi, _mm256_set1_epi8(Delims)))),
+   ...);
+  auto low = static_cast<uint32_t>(_mm256_movemask_epi8(matchLo));
+  auto high = static_cast<uint32_t>(_mm256_movemask_epi8(matchHi));
+  return (uint64_t{high} << 32) | low;
+}
+#elif defined(__SSE2__)
+template <char... Delims> inline uint64_t matchMaskSimd(char const *block) {
+  uint64_t res{0};
+  for (size_t part{0}; part < 4; ++part) {
+    auto chunk = _mm_loadu_si128(
+        reinterpret_cast<__m128i const *>(block + 16 * part));
+    auto match = _mm_setzero_si128();
+    ((match = _mm_or_si128(match,
+                           _mm_cmpeq_epi8(chunk, _mm_set1_epi8(Delims)))),
+     ...);
+    res |= uint64_t{static_cast<uint16_t>(_mm_movemask_epi8(match))}
+           << (16 * part);
+  }
+  return res;
+}
+#endif
+} // namespace detail
+
+// block must have scanBlockSize readable bytes
+template <char... Delims> constexpr uint64_t matchMask(char const *block) {
+  static_assert(sizeof...(Delims) > 0);
+#if defined(__AVX2__) || defined(__SSE2__)
+  if !consteval {
+    return detail::matchMaskSimd<Delims...>(block);
+  }
+#endif
+  return detail::matchMaskScalar<Delims...>(block, scanBlockSize);
+}
+
+// Position of the first delimiter at or after pos, npos if there is none
+template <char... Delims>
+constexpr size_t findFirstOf(std::string_view input, size_t pos = 0) {
+  char const *data = input.data();
+  while (pos + scanBlockSize <= input.size()) {
+    if (auto mask = matchMask<Delims...>(data + pos); mask != 0)
+      return pos + static_cast<size_t>(std::countr_zero(mask));
+    pos += scanBlockSize;
+  }
+  if (pos < input.size()) {
+    auto mask =
+        detail::matchMaskScalar<Delims...>(data + pos, input.size() - pos);
+    if (mask != 0)
+      return pos + static_cast<size_t>(std::countr_zero(mask));
+  }
+  return std::string_view::npos;
+}
+
+static_assert(findFirstOf<'\n'>("abc\ndef") == 3);
+static_assert(findFirstOf<',', '-'>("12-34,5") == 2);
+static_assert(findFirstOf<':'>("no colon") == std::string_view::npos);
+
+// Offsets of every delimiter of input, in order
+template <char... Delims>
+constexpr std::vector<size_t> indexOf(std::string_view input) {
+  std::vector<size_t> res{};
+  size_t pos{0};
+  for (; pos + scanBlockSize <= input.size(); pos += scanBlockSize) {
+    for (auto mask = matchMask<Delims...>(input.data() + pos); mask != 0;
+         mask &= mask - 1) {
+      res.push_back(pos + static_cast<size_t>(std::countr_zero(mask)));
+    }
+  }
+  for (auto mask = detail::matchMaskScalar<Delims...>(input.data() + pos,
+                                                      input.size() - pos);
+       mask != 0; mask &= mask - 1) {
+    res.push_back(pos + static_cast<size_t>(std::countr_zero(mask)));
+  }
+  return res;
+}
+
+static_assert(indexOf<'\n'>("a\nbb\n\nc") == std::vector<size_t>{1, 4, 5});
+
+// Lazy split of a buffer on a delimiter set, yielding views into it.
+// Like std::views::split, a trailing delimiter yields a last empty token.
+template <char... Delims>
+class SplitView : public std::ranges::view_interface<SplitView<Delims...>> {
+public:
+  class iterator {
+  public:
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using iterator_concept = std::forward_iterator_tag;
+
+    constexpr iterator() = default;
+    constexpr iterator(std::string_view input, size_t pos)
+        : input(input), pos(pos), end(findEnd()) {}
+
+    constexpr std::string_view operator*() const {
+      return input.substr(pos, end - pos);
+    }
+    constexpr iterator &operator++() {
+      pos = end == input.size() ? std::string_view::npos : end + 1;
+      end = findEnd();
+      return *this;
+    }
+    constexpr iterator operator++(int) {
+      auto res = *this;
+      ++*this;
+      return res;
+    }
+    constexpr bool operator==(iterator const &other) const {
+      return pos == other.pos;
+    }
+    constexpr bool operator==(std::default_sentinel_t) const {
+      return pos == std::string_view::npos;
+    }
+
+  private:
+    constexpr size_t findEnd() const {
+      if (pos == std::string_view::npos)
+        return pos;
+      return std::min(findFirstOf<Delims...>(input, pos), input.size());
+    }
+    std::string_view input{};
+    size_t pos{std::string_view::npos};
+    size_t end{std::string_view::npos};
+  };
+
+  constexpr SplitView() = default;
+  constexpr SplitView(std::string_view input) : input(input) {}
+
+  constexpr iterator begin() const { return iterator{input, 0}; }
+  constexpr std::default_sentinel_t end() const { return {}; }
+
+private:
+  std::string_view input{};
+};
+
+constexpr SplitView<'\n'> splitLines(std::string_view input) {
+  return {input};
+}
+
+static_assert(std::ranges::forward_range<SplitView<'\n'>>);
+static_assert(std::ranges::view<SplitView<'\n'>>);
+static_assert(std::ranges::distance(splitLines("a\nb\n")) == 3);
+} // namespace utils
+
+#endif // UTILS_SCAN_HPP
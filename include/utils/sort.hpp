@@ -0,0 +1,80 @@
+#ifndef UTILS_SORT_HPP
+#define UTILS_SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ranges>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace utils {
+// Stable LSD radix sort on an unsigned 64-bit key, one byte per pass.
+// Passes on a byte that every key shares are skipped, so small keys only
+// cost the passes on their low bytes.
+template <typename T, typename Key = std::identity>
+constexpr void radixSort(std::span<T> values, Key key = {}) {
+  constexpr size_t nbPasses{8};
+  constexpr size_t radix{256};
+  if (values.size() < radix) {
+    // Insertion sort, stable as well
+    for (size_t i{1}; i < values.size(); ++i) {
+      auto value = std::move(values[i]);
+      auto j{i};
+      for (; j > 0 && key(value) < key(values[j - 1]); --j)
+        values[j] = std::move(values[j - 1]);
+      values[j] = std::move(value);
+    }
+    return;
+  }
+  std::array<std::array<size_t, radix>, nbPasses> counts{};
+  for (auto const &value : values) {
+    uint64_t k = key(value);
+    for (auto &count : counts) {
+      count[k & 0xFF] += 1;
+      k >>= 8;
+    }
+  }
+  std::vector<T> scratch(values.size());
+  std::span<T> source{values};
+  std::span<T> target{scratch};
+  for (size_t pass{0}; pass < nbPasses; ++pass) {
+    auto &offsets = counts[pass];
+    if (std::ranges::contains(offsets, values.size()))
+      continue;
+    size_t total{0};
+    for (auto &offset : offsets)
+      total += std::exchange(offset, total);
+    for (auto const &value : source) {
+      auto digit = (static_cast<uint64_t>(key(value)) >> (8 * pass)) & 0xFF;
+      target[offsets[digit]++] = value;
+    }
+    std::swap(source, target);
+  }
+  if (source.data() != values.data())
+    std::ranges::copy(source, values.begin());
+}
+
+namespace detail {
+constexpr bool checkRadixSort() {
+  std::vector<uint64_t> values{};
+  uint64_t seed{12345};
+  for (size_t i{0}; i < 1000; ++i) {
+    seed = seed * 6364136223846793005 + 1442695040888963407;
+    values.push_back(seed >> (i % 64));
+  }
+  auto expected = values;
+  std::ranges::sort(expected);
+  auto small = std::vector(values.begin(), values.begin() + 100);
+  radixSort(std::span{small});
+  radixSort(std::span{values});
+  return values == expected && std::ranges::is_sorted(small);
+}
+static_assert(checkRadixSort());
+} // namespace detail
+} // namespace utils
+
+#endif // UTILS_SORT_HPP